@@ -1,8 +1,8 @@
 #!/usr/bin/python3
 
 from ast import arg
-from os import mkdir, walk, path
-from sys import argv
+from os import mkdir, walk, path, environ
+from sys import argv, executable
 import json
 import zlib
 import re
@@ -21,15 +21,61 @@ INCLUDE_DIR_FILE = "include_dir"
 
 CPP_STANDARD = 14
 
-DEBUG_FLAGS = ["-std=c++%d"%CPP_STANDARD, "-Wall", "-Wextra", "-g", "-O1", "-fPIC"]
-RELEASE_FLAGS = ["-std=c++%d"%CPP_STANDARD, "-O3", "-Wall", "-Wextra", "-Ofast", "-DNDEBUG", "-fPIC"]
-LINKING_PARAMS = ["-std=c++%d"%CPP_STANDARD, "-lm"]
+DEBUG_FLAGS = ["-std=c++%d"%CPP_STANDARD, "-Wall", "-Wextra", "-g", "-O1", "-fPIC", "-pthread"]
+RELEASE_FLAGS = ["-std=c++%d"%CPP_STANDARD, "-O3", "-Wall", "-Wextra", "-Ofast", "-DNDEBUG", "-fPIC", "-pthread"]
+LINKING_PARAMS = ["-std=c++%d"%CPP_STANDARD, "-lm", "-pthread"]
+
+# tests compiled once more in another configuration of the library - executable name, source, additional compiler flags
+TEST_VARIANTS = [
+    ("test_1_constant_latency", SOURCRE_DIRECTORY+"/test_1.cpp", ["-DTAYLOR_CONSTANT_LATENCY"]),
+    ("test_9_cpp17", SOURCRE_DIRECTORY+"/test_9.cpp", ["-std=c++17"]),
+]
 
 COMMAND_BUILD = "build"
 COMMAND_RELEASE = "release"
 COMMAND_TEST = "test"
+COMMAND_BENCH = "bench"
+COMMAND_BASELINE = "baseline"
+COMMAND_RV32 = "rv32"
+COMMAND_TUNE = "tune"
+OPTION_THRESHOLD = "threshold="
 
 BUILD_INFO = BUILD_DIRECTORY+"/buildInfo.json"
+BENCH_EXECUTABLE = BUILD_DIRECTORY+"/bench"
+BENCH_RESULTS = BUILD_DIRECTORY+"/benchResults.json"
+BENCH_BASELINE = BUILD_DIRECTORY+"/benchBaseline.json"
+# the fastest median of the runs is kept - filters out slow periods of the machine
+BENCH_RUNS = 5
+# relative slowdown of the median (threshold=N on the command line in percent)
+BENCH_THRESHOLD = 0.20
+# the slowdown must also exceed this many median absolute deviations of both runs
+BENCH_NOISE_MADS = 3.0
+# and be at least one cycle per operation - the resolution of the loops with the simplest operations
+BENCH_MIN_CYCLES = 1.0
+# reported only, they are references and not a code of the library
+BENCH_UNTRACKED_FILTER = ".*/cmath/.*"
+
+TUNER_EXECUTABLE = BUILD_DIRECTORY+"/math_tuner"
+TUNER_HEADER = SOURCRE_DIRECTORY+"/mathdispatch_choices.h"
+
+# cross compilation of the benchmark for the target of the library, counted with the PC histogram of spike (configured with --enable-histogram)
+RV32_DIRECTORY = BUILD_DIRECTORY+"/rv32"
+RV32_EXECUTABLE = RV32_DIRECTORY+"/bench"
+RV32_SOURCES = [SOURCRE_DIRECTORY+"/bench.cpp", SOURCRE_DIRECTORY+"/lib/taylormath.cpp"]
+RV32_CXX = environ.get("RV32_CXX", "riscv32-unknown-elf-g++")
+RV32_OBJDUMP = environ.get("RV32_OBJDUMP", "riscv32-unknown-elf-objdump")
+RV32_FLAGS = ["-std=c++%d"%CPP_STANDARD, "-march=rv32im", "-mabi=ilp32", "-O2", "-DNDEBUG", "-Wall", "-Wextra"]
+RV32_EMULATOR = environ.get("RV32_EMULATOR", "spike -g --isa=rv32im pk").split()
+RV32_RESULTS = BUILD_DIRECTORY+"/rv32Results.json"
+RV32_BASELINE = BUILD_DIRECTORY+"/rv32Baseline.json"
+# every kernel is run with RV32_OPS and 2*RV32_OPS operations, the difference removes the start and the fitting of tables
+RV32_OPS = 200
+# the counts are deterministic, a small relative growth of the instructions is already a regression
+RV32_THRESHOLD = 0.01
+RV32_MUL_FILTER = "^mul"
+RV32_DIV_FILTER = "^(div|rem)"
+# helpers of libgcc - 64-bit integer multiplication, division and shifts, soft float
+RV32_LIBCALL_FILTER = "^__[a-z]+[sdt][if][0-9]?$"
 
 def replacePath(baseFileName: str, includeStatement: str):
     base = path.basename(baseFileName)
@@ -109,6 +155,139 @@ def crc32(fileName):
         return "%08X" % (hash & 0xFFFFFFFF)
 
 
+def readBenchmarks(fileName):
+    try:
+        with open(fileName) as f:
+            data = json.loads(f.read())
+        return data, {b["name"]: b for b in data["benchmarks"]}
+    except:
+        return None, None
+
+def runBenchmarks():
+    merged, best = None, dict()
+    for run in range(BENCH_RUNS):
+        sp = subprocess.run([BENCH_EXECUTABLE, "--json", BENCH_RESULTS], stdout=None if run == 0 else subprocess.DEVNULL)
+        data, current = readBenchmarks(BENCH_RESULTS)
+        if sp.returncode or data is None:
+            return None, None
+        merged = data
+        for name, b in current.items():
+            if name not in best or b["median_ns"] < best[name]["median_ns"]:
+                best[name] = b
+    merged["runs"] = BENCH_RUNS
+    merged["benchmarks"] = [best[b["name"]] for b in merged["benchmarks"]]
+    return merged, best
+
+def compareBenchmarks(baseline, current, threshold):
+    regressions = 0
+    print(colored(f"Comparison with {BENCH_BASELINE} (threshold {threshold*100:.1f}%)", "blue"))
+    for name, b in current.items():
+        base = baseline.get(name, None)
+        if base is None:
+            print(f"{name:40}{b['median_ns']:12.3f} ns", colored("new", "yellow"))
+            continue
+        diff = b["median_ns"] - base["median_ns"]
+        delta = diff / base["median_ns"] if base["median_ns"] > 0 else 0.0
+        minDelta = (b["min_ns"] - base["min_ns"]) / base["min_ns"] if base["min_ns"] > 0 else 0.0
+        noise = BENCH_NOISE_MADS * (b["mad_ns"] + base["mad_ns"])
+        cycles = b["median_cycles"] - base["median_cycles"]
+        tracked = re.search(BENCH_UNTRACKED_FILTER, name) is None
+        line = f"{name:40}{base['median_ns']:12.3f} ->{b['median_ns']:10.3f} ns {delta*100:+8.1f}%"
+        if delta > threshold and minDelta > threshold and diff > noise and cycles >= BENCH_MIN_CYCLES and tracked:
+            regressions += 1
+            print(line, colored("REGRESSION", "red"))
+        elif -delta > threshold and -diff > noise:
+            print(line, colored("faster", "green"))
+        else:
+            print(line)
+    for name in baseline.keys():
+        if name not in current:
+            print(f"{name:40}", colored("missing", "yellow"))
+    return regressions
+
+def readDisassembly(fileName):
+    instructions = dict()
+    functions = dict()
+    sp = subprocess.run([RV32_OBJDUMP, "-d", "--no-show-raw-insn", fileName], stdout=subprocess.PIPE, universal_newlines=True)
+    if sp.returncode:
+        return None, None
+    function = re.compile("^([0-9a-f]+) <([^>]+)>:$")
+    instruction = re.compile("^\\s*([0-9a-f]+):\\s+([a-z0-9.]+)")
+    for line in sp.stdout.splitlines():
+        match = function.match(line)
+        if match:
+            functions[int(match.group(1), 16)] = match.group(2)
+            continue
+        match = instruction.match(line)
+        if match:
+            instructions[int(match.group(1), 16)] = match.group(2)
+    return instructions, functions
+
+def countInstructions(name, ops, instructions, functions):
+    command = RV32_EMULATOR + [RV32_EXECUTABLE, "--name", name, "--ops", str(ops), "--repeats", "1", "--warmup", "0"]
+    sp = subprocess.run(command, stdout=subprocess.DEVNULL, stderr=subprocess.PIPE, universal_newlines=True)
+    if sp.returncode:
+        return None
+    counts = {"instructions": 0, "mul": 0, "div": 0, "libcalls": 0}
+    for line in sp.stderr.splitlines():
+        fields = line.split()
+        if len(fields) != 2 or not all(re.match("^[0-9a-fA-F]+$", f) for f in fields):
+            continue
+        pc, count = int(fields[0], 16), int(fields[1])
+        counts["instructions"] += count
+        mnemonic = instructions.get(pc, "")
+        if re.search(RV32_MUL_FILTER, mnemonic):
+            counts["mul"] += count
+        if re.search(RV32_DIV_FILTER, mnemonic):
+            counts["div"] += count
+        if re.search(RV32_LIBCALL_FILTER, functions.get(pc, "")):
+            counts["libcalls"] += count
+    return counts
+
+def runRv32Benchmarks():
+    tryCreateDir(RV32_DIRECTORY)
+    print(colored("*", "blue"), "Cross compilation of", RV32_EXECUTABLE, end="\t", flush=True)
+    sp = subprocess.run([RV32_CXX] + RV32_FLAGS + ["-I"+SOURCRE_DIRECTORY] + RV32_SOURCES + ["-o", RV32_EXECUTABLE, "-lm"])
+    if sp.returncode:
+        print(" [", colored("ERROR", "red"), "]", flush=True)
+        return None
+    print(" [", colored("OK", "green"), "]", flush=True)
+    instructions, functions = readDisassembly(RV32_EXECUTABLE)
+    sp = subprocess.run(RV32_EMULATOR + [RV32_EXECUTABLE, "--list"], stdout=subprocess.PIPE, stderr=subprocess.DEVNULL, universal_newlines=True)
+    if instructions is None or sp.returncode:
+        print(colored("Cannot disassemble or run " + RV32_EXECUTABLE, "red"))
+        return None
+    names = [line.strip() for line in sp.stdout.splitlines() if line.strip()]
+    results = dict()
+    print(f"{'name':40}{'instructions':>14}{'mul':>8}{'div':>8}{'libcalls':>10}  per operation")
+    for name in names:
+        single = countInstructions(name, RV32_OPS, instructions, functions)
+        double = countInstructions(name, 2 * RV32_OPS, instructions, functions)
+        if single is None or double is None:
+            print(f"{name:40}", colored("ERROR", "red"))
+            return None
+        results[name] = {k: (double[k] - single[k]) / RV32_OPS for k in single.keys()}
+        r = results[name]
+        print(f"{name:40}{r['instructions']:14.1f}{r['mul']:8.2f}{r['div']:8.2f}{r['libcalls']:10.2f}")
+    return results
+
+def compareRv32Benchmarks(baseline, current, threshold):
+    regressions = 0
+    print(colored(f"Comparison with {RV32_BASELINE} (threshold {threshold*100:.1f}%)", "blue"))
+    for name, r in current.items():
+        base = baseline.get(name, None)
+        if base is None:
+            print(f"{name:40}", colored("new", "yellow"))
+            continue
+        delta = (r["instructions"] - base["instructions"]) / base["instructions"] if base["instructions"] > 0 else 0.0
+        line = f"{name:40}{base['instructions']:12.1f} ->{r['instructions']:10.1f} {delta*100:+8.1f}%  libcalls {base['libcalls']:.2f} -> {r['libcalls']:.2f}"
+        if delta > threshold or r["libcalls"] > base["libcalls"]:
+            regressions += 1
+            print(line, colored("REGRESSION", "red"))
+        elif delta != 0.0:
+            print(line)
+    return regressions
+
 def isExecutable(fileName):
     with open(fileName, 'r') as f:
         for line in f:
@@ -204,6 +383,24 @@ if not errors and (buildCount > 0 or buildInfo.get("linking_error", False)):
             print(" [", colored("OK", "green"), "]", flush=True)
             newBuildInfo["linking_error"] = False
 
+if not errors:
+    libraryObjects = [getObjectFileName(fileName) for fileName in sources if fileName not in executables]
+    for name, fileName, variantFlags in TEST_VARIANTS:
+        variantObject = BUILD_LIB_DIRECTORY + "/" + name + ".o"
+        variantExecutable = BUILD_DIRECTORY + "/" + name
+        if fileName not in filesToBuild and path.isfile(variantExecutable):
+            continue
+        print(colored("*", "blue"), "Compilation of", fileName, " ".join(variantFlags), end="\t", flush=True)
+        sp = subprocess.run(["g++", "-c"] + flags + variantFlags + include_flags + [fileName, "-o", variantObject])
+        if not sp.returncode:
+            sp = subprocess.run(["g++", variantObject] + libraryObjects + ["-o", variantExecutable] + LINKING_PARAMS, stdout=subprocess.PIPE)
+        if sp.returncode:
+            errors = True
+            newBuildInfo["sources"][fileName] = None
+            print(" [", colored("ERROR", "red"), "]", flush=True)
+        else:
+            print(" [", colored("OK", "green"), "]", flush=True)
+
 if errors:
     failCount = buildInfo.get("fails", 0)+1
     newBuildInfo["fails"] = failCount
@@ -221,8 +418,19 @@ except:
 
 execs = [getExecutableFileName(fileName) for fileName in executables]
 testExecs = [fn for fn in execs if re.search(TEST_FILE_FILTER, fn) is not None]
+testExecs.extend(BUILD_DIRECTORY + "/" + name for name, _, _ in TEST_VARIANTS)
 testExecs.sort()
 
+# the choices are compiled in, so the tuning is followed by a build with the other commands
+if not errors and COMMAND_TUNE in argv:
+    print(colored("Tuning " + TUNER_HEADER, "blue"))
+    sp = subprocess.run([TUNER_EXECUTABLE, TUNER_HEADER])
+    if sp.returncode:
+        print(" [", colored("ERROR", "red"), "]", flush=True)
+        exit(1)
+    sp = subprocess.run([executable, argv[0]] + [arg for arg in argv[1:] if arg != COMMAND_TUNE])
+    exit(sp.returncode)
+
 if not errors:
     if COMMAND_TEST in argv:
         failed = 0
@@ -246,4 +454,68 @@ if not errors:
             print(" [", colored(f"{passed} tests passed, {failed} tests failed", "red"), "] ")
             errors = True
 
+if not errors and (COMMAND_BENCH in argv or (COMMAND_BASELINE in argv and COMMAND_RV32 not in argv)):
+    if COMMAND_RELEASE not in argv:
+        print(colored("Benchmarking a debug build, use release for comparable results", "yellow"))
+    print(colored("Benchmarking " + BENCH_EXECUTABLE, "blue"))
+    results, current = runBenchmarks()
+    if results is None:
+        errors = True
+        print(" [", colored("ERROR", "red"), "]", flush=True)
+    else:
+        results["release"] = COMMAND_RELEASE in argv
+        with open(BENCH_RESULTS, "w") as f:
+            f.write(json.dumps(results, indent=4))
+        print(" [", colored("Results saved to " + BENCH_RESULTS, "green"), "]", flush=True)
+
+        baselineData, baseline = readBenchmarks(BENCH_BASELINE)
+        if COMMAND_BASELINE in argv or baselineData is None:
+            with open(BENCH_BASELINE, "w") as f:
+                f.write(json.dumps(results, indent=4))
+            print(" [", colored("Baseline saved to " + BENCH_BASELINE, "green"), "]", flush=True)
+        else:
+            threshold = BENCH_THRESHOLD
+            for arg in argv:
+                if arg.startswith(OPTION_THRESHOLD):
+                    threshold = float(arg[len(OPTION_THRESHOLD):]) / 100
+            if baselineData.get("release", None) != results["release"]:
+                print(colored("The baseline was measured with other build flags", "yellow"))
+            regressions = compareBenchmarks(baseline, current, threshold)
+            if regressions:
+                errors = True
+                print(" [", colored(f"{regressions} benchmarks regressed", "red"), "] ")
+            else:
+                print(" [", colored("No regressions", "green"), "] ")
+
+if not errors and COMMAND_RV32 in argv:
+    print(colored("Counting instructions of rv32im under " + " ".join(RV32_EMULATOR), "blue"))
+    current = runRv32Benchmarks()
+    if current is None:
+        errors = True
+    else:
+        with open(RV32_RESULTS, "w") as f:
+            f.write(json.dumps(current, indent=4))
+        print(" [", colored("Results saved to " + RV32_RESULTS, "green"), "]", flush=True)
+        baseline = None
+        try:
+            with open(RV32_BASELINE) as f:
+                baseline = json.loads(f.read())
+        except:
+            pass
+        if COMMAND_BASELINE in argv or baseline is None:
+            with open(RV32_BASELINE, "w") as f:
+                f.write(json.dumps(current, indent=4))
+            print(" [", colored("Baseline saved to " + RV32_BASELINE, "green"), "]", flush=True)
+        else:
+            threshold = RV32_THRESHOLD
+            for arg in argv:
+                if arg.startswith(OPTION_THRESHOLD):
+                    threshold = float(arg[len(OPTION_THRESHOLD):]) / 100
+            regressions = compareRv32Benchmarks(baseline, current, threshold)
+            if regressions:
+                errors = True
+                print(" [", colored(f"{regressions} benchmarks regressed on rv32", "red"), "] ")
+            else:
+                print(" [", colored("No regressions on rv32", "green"), "] ")
+
 exit(1 if errors else 0)
@@ -0,0 +1,460 @@
+#include <cstdio>
+#include <cstdint>
+#include <cstdlib>
+#include <cmath>
+#include <chrono>
+#include <iostream>
+#include <fstream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <functional>
+#include <limits>
+#include <type_traits>
+
+#include "lib/fixedpoint.h"
+#include "lib/taylormath.h"
+#include "lib/polyapprox.h"
+#include "lib/polyapprox_compact.h"
+#include "lib/cyclecounter.h"
+
+// Host version of the speed comparision from ArduinoFixedPointTest/tests.h.
+// Every kernel is run warmup times and then repeats times, a single run makes ops operations.
+// Reported are median, minimum and median absolute deviation of nanoseconds per operation and median cycles per operation.
+//
+// usage: bench [--ops N] [--repeats N] [--warmup N] [--filter text] [--name name] [--list] [--json file] [--csv file]
+// file "-" writes to the standard output instead of the table.
+// The tables of polyapprox are fitted by the first run of a kernel, so only the selected ones are created.
+
+
+volatile float result_dump = 0;
+
+// floating point values stay in the floating point registers where the compiler keeps them - a general purpose register
+// would add two moves to the chain of every float and double kernel (without a FPU, f.e. rv32im, they are in the integer registers)
+#if defined(__SSE2__)
+#define BENCH_FLOAT_CONSTRAINT "+x"
+#elif defined(__aarch64__)
+#define BENCH_FLOAT_CONSTRAINT "+w"
+#endif
+
+#ifdef BENCH_FLOAT_CONSTRAINT
+constexpr bool float_registers = true;
+#else
+constexpr bool float_registers = false;
+#endif
+
+template<typename T>
+using in_float_register = std::integral_constant<bool, float_registers && std::is_floating_point<T>::value>;
+
+template<typename T>
+inline typename std::enable_if<in_float_register<T>::value, void>::type keep(T& value) {
+#ifdef BENCH_FLOAT_CONSTRAINT
+    asm volatile("" : BENCH_FLOAT_CONSTRAINT(value));
+#else
+    (void)value;
+#endif
+}
+
+// values wider than a register (64-bit types on rv32) are kept in memory
+template<typename T>
+inline typename std::enable_if<!in_float_register<T>::value && sizeof(T) <= sizeof(void*), void>::type keep(T& value) {
+    asm volatile("" : "+r"(value));
+}
+
+template<typename T>
+inline typename std::enable_if<!in_float_register<T>::value && (sizeof(T) > sizeof(void*)), void>::type keep(T& value) {
+    asm volatile("" : "+m"(value));
+}
+
+
+// unsigned types cannot be mixed with signed integers
+template<typename T>
+using step_type = typename std::conditional<std::numeric_limits<T>::is_signed, signed char, unsigned char>::type;
+
+template<typename T>
+T add_test(unsigned n) {
+    T result = 0;
+    for (unsigned i=0;i<n;i++) {
+        result += (step_type<T>)i;
+        keep(result);
+    }
+    return result;
+}
+
+template<typename T>
+T sub_test(unsigned n) {
+    T result = 0;
+    for (unsigned i=0;i<n;i++) {
+        result -= (step_type<T>)i;
+        keep(result);
+    }
+    return result;
+}
+
+template<typename T>
+T prod_test(unsigned n) {
+    T result = 0.001f;
+    T mul1 = 1.01f;
+    keep(mul1);
+    T mul2 = 0.07907690907008446f;
+    keep(mul2);
+    for (unsigned i=0;i<n;i++) {
+        result *= ((signed char)i) ? mul1 : mul2;
+        keep(result);
+    }
+    return result;
+}
+
+template<typename T>
+T quot_test(unsigned n) {
+    T result = 1000;
+    T div1 = 1.01f;
+    // small types cannot represent the second divisor
+    T div2 = T(0.07907690907008446f) == T(0) ? div1 : T(0.07907690907008446f);
+    keep(div1);
+    keep(div2);
+    for (unsigned i=0;i<n;i++) {
+        result /= ((signed char)i) ? div1 : div2;
+        keep(result);
+    }
+    return result;
+}
+
+template<typename T, typename Fun>
+T math_test(T start, T stop, unsigned n, const Fun& fun) {
+    T span = stop - start;
+    T step = T(span) * T(0.09407208683835973f);
+    T result = 0;
+    T x = start;
+    bool direction = 0;
+    for (unsigned i=0;i<n;i++) {
+        x += step;
+        if (x >= stop) x -= span;
+        if (direction)
+            result -= fun(T(x));
+        else
+            result += fun(T(x));
+        if (std::abs(result) > T(1000)) {
+            direction = !direction;
+            result /= result * T(0.01);
+        }
+    }
+    return result;
+}
+
+
+struct benchmark {
+    std::string type;
+    std::string library;
+    std::string operation;
+    std::function<float(unsigned)> kernel;
+};
+
+struct result {
+    std::string type;
+    std::string library;
+    std::string operation;
+    unsigned ops;
+    unsigned repeats;
+    double median_ns;
+    double min_ns;
+    double mad_ns;
+    double median_cycles;
+};
+
+struct options {
+    unsigned ops = 20000;
+    unsigned repeats = 11;
+    unsigned warmup = 2;
+    std::string filter;
+    std::string name;
+    bool list = false;
+    std::string json;
+    std::string csv;
+};
+
+
+double median(std::vector<double> values) {
+    std::sort(values.begin(), values.end());
+    const size_t n = values.size();
+    return n % 2 ? values[n/2] : (values[n/2 - 1] + values[n/2]) / 2;
+}
+
+result run(const benchmark& b, const options& opt) {
+    for (unsigned i=0;i<opt.warmup;i++)
+        result_dump = b.kernel(opt.ops);
+    std::vector<double> ns, cycles;
+    for (unsigned i=0;i<opt.repeats;i++) {
+        const auto t0 = std::chrono::steady_clock::now();
+        const uint64_t c0 = cycle_counter::now();
+        result_dump = b.kernel(opt.ops);
+        const uint64_t c1 = cycle_counter::now();
+        const auto t1 = std::chrono::steady_clock::now();
+        ns.push_back(std::chrono::duration<double, std::nano>(t1 - t0).count() / opt.ops);
+        cycles.push_back(double(c1 - c0) / opt.ops);
+    }
+    result r;
+    r.type = b.type;
+    r.library = b.library;
+    r.operation = b.operation;
+    r.ops = opt.ops;
+    r.repeats = opt.repeats;
+    r.median_ns = median(ns);
+    r.min_ns = *std::min_element(ns.begin(), ns.end());
+    std::vector<double> deviations;
+    for (double v : ns)
+        deviations.push_back(std::abs(v - r.median_ns));
+    r.mad_ns = median(deviations);
+    r.median_cycles = median(cycles);
+    return r;
+}
+
+
+template<typename T>
+void add_arithmetic(std::vector<benchmark>& list, const std::string& type) {
+    list.push_back({type, "arithmetic", "add", [](unsigned n) {return (float)add_test<T>(n);}});
+    list.push_back({type, "arithmetic", "sub", [](unsigned n) {return (float)sub_test<T>(n);}});
+    list.push_back({type, "arithmetic", "mul", [](unsigned n) {return (float)prod_test<T>(n);}});
+    list.push_back({type, "arithmetic", "div", [](unsigned n) {return (float)quot_test<T>(n);}});
+}
+
+template<typename T>
+void add_taylor(std::vector<benchmark>& list, const std::string& type) {
+    // initialization (if needed)
+    taylor::sin<T>(5);
+    taylor::sqrt<T>(5);
+    taylor::asin<T>(0.5f);
+    taylor::log<T>(0.5f);
+    taylor::exp<T>(10);
+
+    list.push_back({type, "taylormath", "sin", [](unsigned n) {return (float)math_test<T>(-5, 5, n, taylor::sin<T>);}});
+    list.push_back({type, "taylormath", "sqrt", [](unsigned n) {return (float)math_test<T>(0, 5, n, taylor::sqrt<T>);}});
+    list.push_back({type, "taylormath", "asin", [](unsigned n) {return (float)math_test<T>(-0.999, 0.999, n, taylor::asin<T>);}});
+    list.push_back({type, "taylormath", "log", [](unsigned n) {return (float)math_test<T>(0.001, 7, n, taylor::log<T>);}});
+    list.push_back({type, "taylormath", "exp", [](unsigned n) {return (float)math_test<T>(-5, 5, n, taylor::exp<T>);}});
+}
+
+template<typename T>
+const PolyApprox<T>& approx_table(unsigned i) {
+    unsigned m = 31;
+
+    static const std::vector<PolyApprox<T>> tables = {
+        PolyApprox<T>::template create<double>([](double x) {return sin(x);}, m, -5, 5),
+        PolyApprox<T>::template create<double>([](double x) {return sqrt(x);}, m, 0, 5),
+        PolyApprox<T>::template create<double>([](double x) {return asin(x);}, m, -1, 1),
+        PolyApprox<T>::template create<double>([](double x) {return log(x);}, m, 0.001f, 7),
+        PolyApprox<T>::template create<double>([](double x) {return exp(x);}, m, -5, 5),
+    };
+    return tables[i];
+}
+
+template<typename T>
+void add_polyapprox(std::vector<benchmark>& list, const std::string& type) {
+    list.push_back({type, "polyapprox", "sin", [](unsigned n) {return (float)math_test<T>(-5, 5, n, approx_table<T>(0));}});
+    list.push_back({type, "polyapprox", "sqrt", [](unsigned n) {return (float)math_test<T>(0, 5, n, approx_table<T>(1));}});
+    list.push_back({type, "polyapprox", "asin", [](unsigned n) {return (float)math_test<T>(-0.999, 0.999, n, approx_table<T>(2));}});
+    list.push_back({type, "polyapprox", "log", [](unsigned n) {return (float)math_test<T>(0.001, 7, n, approx_table<T>(3));}});
+    list.push_back({type, "polyapprox", "exp", [](unsigned n) {return (float)math_test<T>(-5, 5, n, approx_table<T>(4));}});
+}
+
+template<typename T>
+const IntPolyApprox<T>& int_approx_table(unsigned i) {
+    unsigned m = 31;
+
+    static const std::vector<IntPolyApprox<T>> tables = {
+        IntPolyApprox<T>::template create<double>([](double x) {return sin(x);}, m, -5, 5),
+        IntPolyApprox<T>::template create<double>([](double x) {return sqrt(x);}, m, 0, 5),
+        IntPolyApprox<T>::template create<double>([](double x) {return asin(x);}, m, -1, 1),
+        IntPolyApprox<T>::template create<double>([](double x) {return log(x);}, m, 0.001f, 7),
+        IntPolyApprox<T>::template create<double>([](double x) {return exp(x);}, m, -5, 5),
+    };
+    return tables[i];
+}
+
+// integer Horner of the fixed point types
+template<typename T>
+void add_intpolyapprox(std::vector<benchmark>& list, const std::string& type) {
+    list.push_back({type, "intpoly", "sin", [](unsigned n) {return (float)math_test<T>(-5, 5, n, int_approx_table<T>(0));}});
+    list.push_back({type, "intpoly", "sqrt", [](unsigned n) {return (float)math_test<T>(0, 5, n, int_approx_table<T>(1));}});
+    list.push_back({type, "intpoly", "asin", [](unsigned n) {return (float)math_test<T>(-0.999, 0.999, n, int_approx_table<T>(2));}});
+    list.push_back({type, "intpoly", "log", [](unsigned n) {return (float)math_test<T>(0.001, 7, n, int_approx_table<T>(3));}});
+    list.push_back({type, "intpoly", "exp", [](unsigned n) {return (float)math_test<T>(-5, 5, n, int_approx_table<T>(4));}});
+}
+
+template<typename T>
+void add_std(std::vector<benchmark>& list, const std::string& type) {
+    list.push_back({type, "cmath", "sin", [](unsigned n) {return (float)math_test<T>(-5, 5, n, [](T x) {return std::sin(x);});}});
+    list.push_back({type, "cmath", "sqrt", [](unsigned n) {return (float)math_test<T>(0, 5, n, [](T x) {return std::sqrt(x);});}});
+    list.push_back({type, "cmath", "asin", [](unsigned n) {return (float)math_test<T>(-0.999, 0.999, n, [](T x) {return std::asin(x);});}});
+    list.push_back({type, "cmath", "log", [](unsigned n) {return (float)math_test<T>(0.001, 7, n, [](T x) {return std::log(x);});}});
+    list.push_back({type, "cmath", "exp", [](unsigned n) {return (float)math_test<T>(-5, 5, n, [](T x) {return std::exp(x);});}});
+}
+
+template<typename T>
+void add_math(std::vector<benchmark>& list, const std::string& type) {
+    add_taylor<T>(list, type);
+    add_polyapprox<T>(list, type);
+}
+
+
+std::vector<benchmark> all_benchmarks() {
+    std::vector<benchmark> list;
+
+    add_arithmetic<fixed8>(list, "fixed8");
+    add_arithmetic<fixed16>(list, "fixed16");
+    add_arithmetic<fixed32>(list, "fixed32");
+    add_arithmetic<fixed64>(list, "fixed64");
+    add_arithmetic<ufixed8>(list, "ufixed8");
+    add_arithmetic<ufixed16>(list, "ufixed16");
+    add_arithmetic<ufixed32>(list, "ufixed32");
+    add_arithmetic<ufixed64>(list, "ufixed64");
+    add_arithmetic<fixed8_a>(list, "fixed8_a");
+    add_arithmetic<fixed16_a>(list, "fixed16_a");
+    add_arithmetic<fixed32_a>(list, "fixed32_a");
+    add_arithmetic<fixed64_a>(list, "fixed64_a");
+    add_arithmetic<ufixed8_a>(list, "ufixed8_a");
+    add_arithmetic<ufixed16_a>(list, "ufixed16_a");
+    add_arithmetic<ufixed32_a>(list, "ufixed32_a");
+    add_arithmetic<ufixed64_a>(list, "ufixed64_a");
+    add_arithmetic<fixed8_s>(list, "fixed8_s");
+    add_arithmetic<fixed16_s>(list, "fixed16_s");
+    add_arithmetic<fixed32_s>(list, "fixed32_s");
+    add_arithmetic<fixed64_s>(list, "fixed64_s");
+    add_arithmetic<ufixed8_s>(list, "ufixed8_s");
+    add_arithmetic<ufixed16_s>(list, "ufixed16_s");
+    add_arithmetic<ufixed32_s>(list, "ufixed32_s");
+    add_arithmetic<ufixed64_s>(list, "ufixed64_s");
+    add_arithmetic<float>(list, "float");
+    add_arithmetic<double>(list, "double");
+
+    // the math modules need a few integer bits for the test ranges
+    add_math<fixed32>(list, "fixed32");
+    add_math<fixed32_a>(list, "fixed32_a");
+    add_math<fixed32_s>(list, "fixed32_s");
+    add_math<fixed64>(list, "fixed64");
+    add_math<fixed64_s>(list, "fixed64_s");
+    add_math<float>(list, "float");
+    add_math<double>(list, "double");
+    add_intpolyapprox<fixed32>(list, "fixed32");
+    add_intpolyapprox<fixed32_a>(list, "fixed32_a");
+    add_intpolyapprox<fixed32_s>(list, "fixed32_s");
+    add_intpolyapprox<fixed64>(list, "fixed64");
+    add_intpolyapprox<fixed64_s>(list, "fixed64_s");
+    add_std<float>(list, "float");
+    add_std<double>(list, "double");
+
+    return list;
+}
+
+
+void print_table(std::ostream& out, const std::vector<result>& results) {
+    out << std::left << std::setw(12) << "type" << std::setw(12) << "library" << std::setw(8) << "op" << std::right
+        << std::setw(12) << "median ns" << std::setw(12) << "min ns" << std::setw(12) << "mad ns" << std::setw(12) << "cycles" << std::endl;
+    out << std::fixed << std::setprecision(3);
+    for (const auto& r : results)
+        out << std::left << std::setw(12) << r.type << std::setw(12) << r.library << std::setw(8) << r.operation << std::right
+            << std::setw(12) << r.median_ns << std::setw(12) << r.min_ns << std::setw(12) << r.mad_ns << std::setw(12) << r.median_cycles << std::endl;
+}
+
+void print_csv(std::ostream& out, const std::vector<result>& results) {
+    out << "name,type,library,operation,ops,repeats,median_ns,min_ns,mad_ns,median_cycles\n";
+    out << std::setprecision(6);
+    for (const auto& r : results)
+        out << r.type << "/" << r.library << "/" << r.operation << "," << r.type << "," << r.library << "," << r.operation << ","
+            << r.ops << "," << r.repeats << "," << r.median_ns << "," << r.min_ns << "," << r.mad_ns << "," << r.median_cycles << "\n";
+}
+
+void print_json(std::ostream& out, const std::vector<result>& results) {
+    out << "{\n    \"unit\": \"ns/op\",\n    \"benchmarks\": [\n";
+    out << std::setprecision(6);
+    for (size_t i=0;i<results.size();i++) {
+        const auto& r = results[i];
+        out << "        {\"name\": \"" << r.type << "/" << r.library << "/" << r.operation << "\", \"type\": \"" << r.type
+            << "\", \"library\": \"" << r.library << "\", \"operation\": \"" << r.operation << "\", \"ops\": " << r.ops
+            << ", \"repeats\": " << r.repeats << ", \"median_ns\": " << r.median_ns << ", \"min_ns\": " << r.min_ns
+            << ", \"mad_ns\": " << r.mad_ns << ", \"median_cycles\": " << r.median_cycles << "}"
+            << (i + 1 < results.size() ? "," : "") << "\n";
+    }
+    out << "    ]\n}\n";
+}
+
+bool write(const std::string& fileName, const std::vector<result>& results, void (*printer)(std::ostream&, const std::vector<result>&)) {
+    if (fileName == "-") {
+        printer(std::cout, results);
+        return true;
+    }
+    std::ofstream file(fileName);
+    if (!file)
+        return false;
+    printer(file, results);
+    return bool(file);
+}
+
+
+bool parse(int argc, char** argv, options& opt) {
+    for (int i=1;i<argc;i++) {
+        const std::string arg = argv[i];
+        if (arg == "--list") {
+            opt.list = true;
+            continue;
+        }
+        if (i + 1 >= argc)
+            return false;
+        const std::string value = argv[++i];
+        if (arg == "--ops")
+            opt.ops = std::max(1, std::atoi(value.c_str()));
+        else if (arg == "--repeats")
+            opt.repeats = std::max(1, std::atoi(value.c_str()));
+        else if (arg == "--warmup")
+            opt.warmup = std::max(0, std::atoi(value.c_str()));
+        else if (arg == "--filter")
+            opt.filter = value;
+        else if (arg == "--name")
+            opt.name = value;
+        else if (arg == "--json")
+            opt.json = value;
+        else if (arg == "--csv")
+            opt.csv = value;
+        else
+            return false;
+    }
+    return true;
+}
+
+
+int main(int argc, char** argv) {
+
+    options opt;
+    if (!parse(argc, argv, opt)) {
+        std::cerr << "usage: bench [--ops N] [--repeats N] [--warmup N] [--filter text] [--name name] [--list] [--json file] [--csv file]" << std::endl;
+        return 2;
+    }
+
+    std::vector<result> results;
+    for (const auto& b : all_benchmarks()) {
+        const std::string name = b.type + "/" + b.library + "/" + b.operation;
+        if ((!opt.filter.empty() && name.find(opt.filter) == std::string::npos) || (!opt.name.empty() && name != opt.name))
+            continue;
+        if (opt.list) {
+            std::cout << name << "\n";
+            continue;
+        }
+        results.push_back(run(b, opt));
+    }
+
+    if (opt.list)
+        return 0;
+    if (opt.json != "-" && opt.csv != "-")
+        print_table(std::cout, results);
+    if (!opt.json.empty() && !write(opt.json, results, print_json)) {
+        std::cerr << "Cannot write " << opt.json << std::endl;
+        return 1;
+    }
+    if (!opt.csv.empty() && !write(opt.csv, results, print_csv)) {
+        std::cerr << "Cannot write " << opt.csv << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
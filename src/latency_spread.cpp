@@ -0,0 +1,94 @@
+#include <cstdio>
+#include <cstdint>
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <functional>
+
+#include "lib/fixedpoint.h"
+#include "lib/taylormath.h"
+#include "lib/polyapprox.h"
+#include "lib/cyclecounter.h"
+
+// Prints the minimum and maximum latency of the default and constant latency functions and of PolyApprox::call over the domain sweep.
+// For every argument the fastest of the repeated calls is taken, so the spread shows data dependent timing only.
+
+
+template<typename T, typename Fun>
+void spread(const std::string& name, double start, double stop, unsigned n, Fun fun) {
+    // initialize tables
+    fun(T(start));
+    uint64_t min_cycles = ~(uint64_t)0;
+    uint64_t max_cycles = 0;
+    double min_x = start, max_x = start;
+    for (unsigned i=0;i<n;i++) {
+        double x = start + i * (stop - start) / n;
+        uint64_t cycles = cycle_counter::measure<T, Fun>(fun, T(x));
+        if (cycles < min_cycles) { min_cycles = cycles; min_x = x; }
+        if (cycles > max_cycles) { max_cycles = cycles; max_x = x; }
+    }
+    std::cout << std::left << std::setw(32) << name << std::right
+              << std::setw(8) << min_cycles << " (x = " << std::setw(9) << std::setprecision(4) << min_x << ")"
+              << std::setw(8) << max_cycles << " (x = " << std::setw(9) << std::setprecision(4) << max_x << ")"
+              << std::setw(8) << (max_cycles - min_cycles) << std::endl;
+}
+
+
+template<typename T>
+void spread_approx(const std::string& name, double start, double stop, unsigned n, double (*src)(double)) {
+    const PolyApprox<T> approx = PolyApprox<T>::template create<double>(src, 256, start, stop);
+    spread<T>(name, start, stop, n, [&approx](T x) {return approx.call(x);});
+}
+
+
+template<typename T>
+void spread_all(const std::string& type_name, unsigned n) {
+    spread<T>(type_name + " sin", -10, 10, n, taylor::sin<T>);
+    spread<T>(type_name + " constant_latency::sin", -10, 10, n, taylor::constant_latency::sin<T>);
+    spread<T>(type_name + " cos", -10, 10, n, taylor::cos<T>);
+    spread<T>(type_name + " constant_latency::cos", -10, 10, n, taylor::constant_latency::cos<T>);
+    spread<T>(type_name + " sqrt", 0, 16, n, taylor::sqrt<T>);
+    spread<T>(type_name + " constant_latency::sqrt", 0, 16, n, taylor::constant_latency::sqrt<T>);
+    spread<T>(type_name + " asin", -1, 1, n, taylor::asin<T>);
+    spread<T>(type_name + " constant_latency::asin", -1, 1, n, taylor::constant_latency::asin<T>);
+    spread<T>(type_name + " log", 1e-3, 10, n, taylor::log<T>);
+    spread<T>(type_name + " constant_latency::log", 1e-3, 10, n, taylor::constant_latency::log<T>);
+    spread<T>(type_name + " exp", -10, 10, n, taylor::exp<T>);
+    spread<T>(type_name + " constant_latency::exp", -10, 10, n, taylor::constant_latency::exp<T>);
+    spread<T>(type_name + " acos", -1, 1, n, taylor::acos<T>);
+    spread<T>(type_name + " constant_latency::acos", -1, 1, n, taylor::constant_latency::acos<T>);
+    spread<T>(type_name + " tan", -1.5, 1.5, n, taylor::tan<T>);
+    spread<T>(type_name + " constant_latency::tan", -1.5, 1.5, n, taylor::constant_latency::tan<T>);
+    spread<T>(type_name + " atan", -10, 10, n, taylor::atan<T>);
+    spread<T>(type_name + " constant_latency::atan", -10, 10, n, taylor::constant_latency::atan<T>);
+    // x = 1 - y^2 goes through all four quadrants
+    spread<T>(type_name + " atan2", -2, 2, n, [](T y) {return taylor::atan2<T>(y, 1 - y * y);});
+    spread<T>(type_name + " constant_latency::atan2", -2, 2, n, [](T y) {return taylor::constant_latency::atan2<T>(y, 1 - y * y);});
+    spread<T>(type_name + " sinh", -10, 10, n, taylor::sinh<T>);
+    spread<T>(type_name + " constant_latency::sinh", -10, 10, n, taylor::constant_latency::sinh<T>);
+    spread<T>(type_name + " cosh", -10, 10, n, taylor::cosh<T>);
+    spread<T>(type_name + " constant_latency::cosh", -10, 10, n, taylor::constant_latency::cosh<T>);
+    spread<T>(type_name + " tanh", -10, 10, n, taylor::tanh<T>);
+    spread<T>(type_name + " constant_latency::tanh", -10, 10, n, taylor::constant_latency::tanh<T>);
+    spread_approx<T>(type_name + " PolyApprox::call sin", -10, 10, n, sin);
+    spread_approx<T>(type_name + " PolyApprox::call sqrt", 0, 16, n, sqrt);
+    spread_approx<T>(type_name + " PolyApprox::call log", 1e-3, 10, n, log);
+    spread_approx<T>(type_name + " PolyApprox::call exp", -10, 10, n, exp);
+}
+
+
+int main() {
+
+    unsigned n = 1001;
+
+    std::cout << std::left << std::setw(32) << "function" << std::right
+              << std::setw(25) << "min" << std::setw(25) << "max" << std::setw(8) << "spread" << std::endl;
+
+    spread_all<float>("float", n);
+    spread_all<double>("double", n);
+    spread_all<fixed32_a>("fixed32_a", n);
+    spread_all<fixed32_s>("fixed32_s", n);
+    spread_all<fixed64>("fixed64", n);
+
+    return 0;
+}
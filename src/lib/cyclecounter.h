@@ -0,0 +1,92 @@
+/****************************************************************************************
+
+                                       MIT License
+
+               Copyright (c) 2025 Pawel Bielecki [pbielecki2000@gmail.com]
+
+       Permission is hereby granted, free of charge, to any person obtaining a copy
+      of this software and associated documentation files (the "Software"), to deal
+       in the Software without restriction, including without limitation the rights
+        to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+          copies of the Software, and to permit persons to whom the Software is
+                 furnished to do so, subject to the following conditions:
+
+      The above copyright notice and this permission notice shall be included in all
+                     copies or substantial portions of the Software.
+
+        THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+         IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+       FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+          AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+      LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+      OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+                                        SOFTWARE.
+
+****************************************************************************************/
+
+#ifndef CYCLE_COUNTER
+#define CYCLE_COUNTER
+
+#include <cstdint>
+
+#if !defined(__x86_64__) && !defined(__i386__) && !defined(__riscv) && !defined(__aarch64__)
+#include <chrono>
+#endif
+
+
+namespace cycle_counter {
+
+    // raw counter of the core - cycles on x86 (TSC) and RISC-V, virtual timer ticks on aarch64, nanoseconds elsewhere
+    inline uint64_t now() {
+        #if defined(__x86_64__) || defined(__i386__)
+        uint32_t lo, hi;
+        asm volatile("lfence\n\trdtsc" : "=a"(lo), "=d"(hi) :: "memory");
+        return ((uint64_t)hi << 32) | lo;
+        #elif defined(__riscv) && __riscv_xlen == 32
+        uint32_t lo, hi, hi2;
+        do {
+            asm volatile("rdcycleh %0" : "=r"(hi));
+            asm volatile("rdcycle %0" : "=r"(lo));
+            asm volatile("rdcycleh %0" : "=r"(hi2));
+        } while (hi != hi2);
+        return ((uint64_t)hi << 32) | lo;
+        #elif defined(__riscv)
+        uint64_t cycles;
+        asm volatile("rdcycle %0" : "=r"(cycles));
+        return cycles;
+        #elif defined(__aarch64__)
+        uint64_t ticks;
+        asm volatile("isb\n\tmrs %0, cntvct_el0" : "=r"(ticks) :: "memory");
+        return ticks;
+        #else
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+        #endif
+    }
+
+
+    // forces the value to be calculated and stored - the measured call cannot be removed by the optimizer
+    template<typename T>
+    inline void clobber(T& value) {
+        asm volatile("" : : "r"(&value) : "memory");
+    }
+
+
+    // minimum count of repeats calls of fun(x) - filters out interrupts and cache misses
+    template<typename T, typename Fun>
+    uint64_t measure(Fun fun, T x, unsigned repeats=32) {
+        uint64_t best = ~(uint64_t)0;
+        for (unsigned i=0;i<repeats;i++) {
+            T arg = x;
+            clobber(arg);
+            uint64_t start = now();
+            T result = fun(arg);
+            clobber(result);
+            uint64_t elapsed = now() - start;
+            if (elapsed < best) best = elapsed;
+        }
+        return best;
+    }
+
+}
+
+#endif
@@ -0,0 +1,131 @@
+/****************************************************************************************
+
+                                       MIT License
+
+               Copyright (c) 2025 Pawel Bielecki [pbielecki2000@gmail.com]
+
+       Permission is hereby granted, free of charge, to any person obtaining a copy
+      of this software and associated documentation files (the "Software"), to deal
+       in the Software without restriction, including without limitation the rights
+        to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+          copies of the Software, and to permit persons to whom the Software is
+                 furnished to do so, subject to the following conditions:
+
+      The above copyright notice and this permission notice shall be included in all
+                     copies or substantial portions of the Software.
+
+        THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+         IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+       FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+          AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+      LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+      OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+                                        SOFTWARE.
+
+****************************************************************************************/
+
+
+#ifndef MATH_DISPATCH
+#define MATH_DISPATCH
+
+#include <cmath>
+
+#include "fixedpoint.h"
+#include "taylormath.h"
+#include "polyapprox.h"
+
+
+// Compile time choice of the implementation of a math function for a call site.
+// A site declares the function, its argument type, the range and the allowed error:
+//     MATH_DISPATCH_SITE(control_sin, sin, float, -3.1416, 3.1416, 1e-5)
+//     y = math_dispatch::call<control_sin>(x);
+// By default taylormath of the argument type is used, a header generated by src/math_tuner.cpp specializes
+// math_dispatch::choice with the fastest implementation which meets the error on the machine of the tuning.
+namespace math_dispatch {
+
+    enum class implementation {
+        std_math,       // cmath of a floating point type
+        taylor,
+        approx          // PolyApprox, the table is returned by choice::table()
+    };
+
+    #define MATH_DISPATCH_FUNCTION(fun) \
+        struct fun##_function { \
+            static constexpr const char* name() {return #fun;} \
+            static double reference(double x) {return std::fun(x);} \
+            template<typename T> static T std_call(T x) {return std::fun(x);} \
+            template<typename T> static T taylor_call(T x) {return taylor::fun<T>(x);} \
+        };
+
+    MATH_DISPATCH_FUNCTION(sin)
+    MATH_DISPATCH_FUNCTION(cos)
+    MATH_DISPATCH_FUNCTION(tan)
+    MATH_DISPATCH_FUNCTION(asin)
+    MATH_DISPATCH_FUNCTION(acos)
+    MATH_DISPATCH_FUNCTION(atan)
+    MATH_DISPATCH_FUNCTION(sinh)
+    MATH_DISPATCH_FUNCTION(cosh)
+    MATH_DISPATCH_FUNCTION(tanh)
+    MATH_DISPATCH_FUNCTION(exp)
+    MATH_DISPATCH_FUNCTION(log)
+    MATH_DISPATCH_FUNCTION(sqrt)
+
+    #undef MATH_DISPATCH_FUNCTION
+
+
+    template<implementation impl_, typename Calculation>
+    struct selected {
+        static constexpr implementation impl = impl_;
+        using type = Calculation;
+    };
+
+    // specialized by the generated header
+    template<typename Site>
+    struct choice : selected<implementation::taylor, typename Site::type> {};
+
+
+    template<typename Site, typename Choice, implementation impl = Choice::impl>
+    struct dispatcher;
+
+    template<typename Site, typename Choice>
+    struct dispatcher<Site, Choice, implementation::std_math> {
+        using T = typename Site::type;
+        using C = typename Choice::type;
+        static T call(T x) {return T(Site::function::template std_call<C>(C(x)));}
+    };
+
+    template<typename Site, typename Choice>
+    struct dispatcher<Site, Choice, implementation::taylor> {
+        using T = typename Site::type;
+        using C = typename Choice::type;
+        static T call(T x) {return T(Site::function::template taylor_call<C>(C(x)));}
+    };
+
+    template<typename Site, typename Choice>
+    struct dispatcher<Site, Choice, implementation::approx> {
+        using T = typename Site::type;
+        using C = typename Choice::type;
+        static T call(T x) {return T(Choice::table()(C(x)));}
+    };
+
+
+    template<typename Site, typename Choice = choice<Site>>
+    inline typename Site::type call(typename Site::type x) {
+        return dispatcher<Site, Choice>::call(x);
+    }
+
+}
+
+
+#define MATH_DISPATCH_SITE(site, fun, T, range_min, range_max, error) \
+    struct site { \
+        using function = math_dispatch::fun##_function; \
+        using type = T; \
+        static constexpr const char* name() {return #site;} \
+        static constexpr const char* type_name() {return #T;} \
+        static constexpr double min() {return range_min;} \
+        static constexpr double max() {return range_max;} \
+        static constexpr double max_error() {return error;} \
+    };
+
+#endif
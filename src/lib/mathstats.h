@@ -0,0 +1,307 @@
+/****************************************************************************************
+
+                                       MIT License
+
+               Copyright (c) 2025 Pawel Bielecki [pbielecki2000@gmail.com]
+
+       Permission is hereby granted, free of charge, to any person obtaining a copy
+      of this software and associated documentation files (the "Software"), to deal
+       in the Software without restriction, including without limitation the rights
+        to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+          copies of the Software, and to permit persons to whom the Software is
+                 furnished to do so, subject to the following conditions:
+
+      The above copyright notice and this permission notice shall be included in all
+                     copies or substantial portions of the Software.
+
+        THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+         IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+       FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+          AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+      LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+      OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+                                        SOFTWARE.
+
+****************************************************************************************/
+
+
+#ifndef MATH_STATISTICS
+#define MATH_STATISTICS
+
+
+// Opt-in instrumentation of the math modules - define MATH_STATS before including taylormath.h / polyapprox.h.
+// Without it the macros below are empty and nothing is compiled in. Use the same setting in all translation units.
+//
+// Every instrumented function records per instantiated type: the calls, the iterations of the series / searches
+// and a histogram of the latency in cycles (cyclecounter.h). Only the outermost instrumented call is recorded,
+// f.e. taylor::ln with its square roots is one call of taylor::ln with the iterations of all of them.
+// The counters live in thread local storage (written without locks by their thread), snapshot() merges all threads.
+
+
+#ifdef MATH_STATS
+
+#include <cmath>
+#include <array>
+#include <mutex>
+#include <atomic>
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include <algorithm>
+#include <type_traits>
+#include <typeinfo>
+
+#include "cyclecounter.h"
+
+#ifndef MATH_STATS_MAX_SITES
+#define MATH_STATS_MAX_SITES 64
+#endif
+
+
+template<typename T, typename TC, unsigned frac_bits> class fixedpoint;
+
+
+namespace math_stats {
+
+    // bucket 0 - 0 cycles, bucket b - [2^(b-1), 2^b) cycles, the last one is open
+    constexpr static const unsigned histogram_buckets = 32;
+    // functions (with types) above the limit are not recorded
+    constexpr static const unsigned max_sites = MATH_STATS_MAX_SITES;
+
+
+    struct function_stats {
+        std::string function;
+        std::string type;
+        std::uint64_t calls;
+        std::uint64_t iterations;
+        std::uint64_t max_iterations;
+        std::uint64_t cycles;
+        std::array<std::uint64_t, histogram_buckets> histogram;
+    };
+
+
+    template<typename T>
+    struct type_name {
+        static std::string get() {
+            return std::is_same<T, float>::value ? "float" : std::is_same<T, double>::value ? "double"
+                 : std::is_same<T, long double>::value ? "long double" : typeid(T).name();
+        }
+    };
+
+    template<typename T, typename TC, unsigned frac_bits>
+    struct type_name<fixedpoint<T, TC, frac_bits>> {
+        static std::string integer(bool is_signed, std::size_t size) {
+            return (is_signed ? "int" : "uint") + std::to_string(8 * size);
+        }
+
+        static std::string get() {
+            return "fixedpoint<" + integer(std::is_signed<T>::value, sizeof(T)) + ", " + integer(std::is_signed<TC>::value, sizeof(TC))
+                 + ", " + std::to_string(frac_bits) + ">";
+        }
+    };
+
+
+    namespace details {
+
+        struct site_counters {
+            std::atomic<std::uint64_t> calls{0};
+            std::atomic<std::uint64_t> iterations{0};
+            std::atomic<std::uint64_t> max_iterations{0};
+            std::atomic<std::uint64_t> cycles{0};
+            std::atomic<std::uint64_t> histogram[histogram_buckets] = {};
+        };
+
+        struct thread_counters;
+
+        struct registry {
+            std::mutex mutex;
+            std::vector<std::pair<std::string, std::string>> sites;
+            std::vector<thread_counters*> threads;
+            // counters of finished threads
+            std::vector<function_stats> retired;
+        };
+
+        inline registry& global() {
+            static registry r;
+            return r;
+        }
+
+        // only the owner thread writes - relaxed load and store, no locked instructions
+        inline void add(std::atomic<std::uint64_t>& counter, std::uint64_t value) noexcept {
+            counter.store(counter.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+        }
+
+        inline void merge(function_stats& stats, const site_counters& counters) noexcept {
+            stats.calls += counters.calls.load(std::memory_order_relaxed);
+            stats.iterations += counters.iterations.load(std::memory_order_relaxed);
+            stats.max_iterations = std::max<std::uint64_t>(stats.max_iterations, counters.max_iterations.load(std::memory_order_relaxed));
+            stats.cycles += counters.cycles.load(std::memory_order_relaxed);
+            for (unsigned b=0;b<histogram_buckets;b++)
+                stats.histogram[b] += counters.histogram[b].load(std::memory_order_relaxed);
+        }
+
+        struct thread_counters {
+            site_counters sites[max_sites];
+
+            thread_counters() {
+                registry& r = global();
+                std::lock_guard<std::mutex> lock(r.mutex);
+                r.threads.push_back(this);
+            }
+
+            ~thread_counters() {
+                registry& r = global();
+                std::lock_guard<std::mutex> lock(r.mutex);
+                for (std::size_t i=0;i<r.sites.size();i++)
+                    merge(r.retired[i], sites[i]);
+                r.threads.erase(std::find(r.threads.begin(), r.threads.end(), this));
+            }
+        };
+
+        inline thread_counters& local() {
+            static thread_local thread_counters counters;
+            return counters;
+        }
+
+        // depth of the instrumented calls and the iterations of the thread
+        inline unsigned& depth() noexcept {
+            static thread_local unsigned value = 0;
+            return value;
+        }
+
+        inline std::uint64_t& iterations() noexcept {
+            static thread_local std::uint64_t value = 0;
+            return value;
+        }
+
+        inline unsigned add_site(const std::string& function, const std::string& type) {
+            registry& r = global();
+            std::lock_guard<std::mutex> lock(r.mutex);
+            if (r.sites.size() >= max_sites)
+                return max_sites;
+            r.sites.emplace_back(function, type);
+            r.retired.push_back(function_stats{function, type, 0, 0, 0, 0, {}});
+            return r.sites.size() - 1;
+        }
+
+        template<typename Tag, typename T>
+        unsigned site_id() {
+            static const unsigned id = add_site(Tag::function(), type_name<T>::get());
+            return id;
+        }
+
+        inline unsigned bucket(std::uint64_t cycles) noexcept {
+            unsigned b = 0;
+            while (cycles && b + 1 < histogram_buckets) {
+                cycles >>= 1;
+                b++;
+            }
+            return b;
+        }
+
+        inline void record(unsigned id, std::uint64_t cycles, std::uint64_t iterations) {
+            if (id >= max_sites)
+                return;
+            site_counters& counters = local().sites[id];
+            add(counters.calls, 1);
+            add(counters.iterations, iterations);
+            if (iterations > counters.max_iterations.load(std::memory_order_relaxed))
+                counters.max_iterations.store(iterations, std::memory_order_relaxed);
+            add(counters.cycles, cycles);
+            add(counters.histogram[bucket(cycles)], 1);
+        }
+
+    }
+
+
+    // measures the enclosing call if it is not nested in another instrumented call
+    template<typename Tag, typename T>
+    class scope {
+        public:
+            scope() noexcept : outer(details::depth()++ == 0) {
+                if (outer) {
+                    start_iterations = details::iterations();
+                    start = cycle_counter::now();
+                }
+            }
+
+            ~scope() {
+                if (outer) {
+                    const std::uint64_t elapsed = cycle_counter::now() - start;
+                    details::record(details::site_id<Tag, T>(), elapsed, details::iterations() - start_iterations);
+                }
+                details::depth()--;
+            }
+
+            scope(const scope&) = delete;
+            scope& operator=(const scope&) = delete;
+
+        private:
+            bool outer;
+            std::uint64_t start_iterations = 0;
+            std::uint64_t start = 0;
+    };
+
+
+    // merged counters of all threads (running and finished), sorted by function and type
+    inline std::vector<function_stats> snapshot() {
+        details::registry& r = details::global();
+        std::lock_guard<std::mutex> lock(r.mutex);
+        std::vector<function_stats> result = r.retired;
+        for (const details::thread_counters* t : r.threads)
+            for (std::size_t i=0;i<result.size();i++)
+                details::merge(result[i], t->sites[i]);
+        std::sort(result.begin(), result.end(), [](const function_stats& a, const function_stats& b) {
+            return (a.function != b.function) ? a.function < b.function : a.type < b.type;
+        });
+        return result;
+    }
+
+
+    // zeroes all counters - calls running on other threads at the same time may be partially lost
+    inline void reset() {
+        details::registry& r = details::global();
+        std::lock_guard<std::mutex> lock(r.mutex);
+        for (auto& stats : r.retired)
+            stats = function_stats{stats.function, stats.type, 0, 0, 0, 0, {}};
+        for (details::thread_counters* t : r.threads) {
+            for (auto& counters : t->sites) {
+                counters.calls.store(0, std::memory_order_relaxed);
+                counters.iterations.store(0, std::memory_order_relaxed);
+                counters.max_iterations.store(0, std::memory_order_relaxed);
+                counters.cycles.store(0, std::memory_order_relaxed);
+                for (auto& h : counters.histogram)
+                    h.store(0, std::memory_order_relaxed);
+            }
+        }
+    }
+
+
+    // upper bound of the latency (cycles) of the fraction q of the calls - from the histogram, so rounded up to a power of 2
+    inline std::uint64_t quantile(const function_stats& stats, double q) {
+        const std::uint64_t rank = std::ceil(q * stats.calls);
+        std::uint64_t count = 0;
+        for (unsigned b=0;b<histogram_buckets;b++) {
+            count += stats.histogram[b];
+            if (count >= rank && count > 0)
+                return b ? ((std::uint64_t)1 << b) - 1 : 0;
+        }
+        return 0;
+    }
+
+}
+
+#define MATH_STATS_SCOPE(name, T) \
+    struct math_stats_tag {static const char* function() {return name;}}; \
+    math_stats::scope<math_stats_tag, T> math_stats_scope;
+#define MATH_STATS_ITERATIONS(n) {math_stats::details::iterations() += (n);}
+
+#else
+
+#define MATH_STATS_SCOPE(name, T)
+#define MATH_STATS_ITERATIONS(n) {}
+
+#endif
+
+#endif
@@ -0,0 +1,360 @@
+/****************************************************************************************
+
+                                       MIT License
+
+               Copyright (c) 2025 Pawel Bielecki [pbielecki2000@gmail.com]
+
+       Permission is hereby granted, free of charge, to any person obtaining a copy
+      of this software and associated documentation files (the "Software"), to deal
+       in the Software without restriction, including without limitation the rights
+        to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+          copies of the Software, and to permit persons to whom the Software is
+                 furnished to do so, subject to the following conditions:
+
+      The above copyright notice and this permission notice shall be included in all
+                     copies or substantial portions of the Software.
+
+        THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+         IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+       FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+          AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+      LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+      OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+                                        SOFTWARE.
+
+****************************************************************************************/
+
+
+#ifndef MATH_SWEEP
+#define MATH_SWEEP
+
+#include <cmath>
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <limits>
+#include <ostream>
+#include <fstream>
+#include <iomanip>
+#include <algorithm>
+#include <functional>
+#include <type_traits>
+
+#include "fixedpoint.h"
+#include "taylormath.h"
+#include "polyapprox.h"
+#include "polyapprox_parallel.h"
+
+
+// Accuracy and cost of the math functions for many types - every case is sampled on all threads and then timed on one.
+// Define TAYLOR_LOOP_COUNTER before including taylormath.h to get the iterations (it makes the taylor calls a little slower).
+namespace math_sweep {
+
+    enum class sampling {
+        dense,          // samples points evenly spaced in [start, stop)
+        exhaustive      // every representable value of the type in [start, stop), strided to at most samples points
+    };
+
+    struct config {
+        sampling mode = sampling::dense;
+        std::size_t samples = 101;
+        unsigned threads = polyapprox_parallel::default_thread_count();
+        unsigned timing_repeats = 5;
+        std::vector<std::string> types;         // empty - all types
+        std::vector<std::string> groups;        // "std", "taylor", "approx", empty - all groups
+        std::vector<std::string> functions;     // empty - all functions
+        std::vector<unsigned> parts = {31};     // part counts of PolyApprox
+        PolyApproxFit fit = PolyApproxFit::hermite;
+        std::string plots_directory;            // not empty - {type}_{group}_{function}.txt files for plots/plot.py
+    };
+
+    struct point {
+        double x;
+        double y;
+        std::size_t loops;
+    };
+
+    struct result {
+        std::string type;
+        std::string group;
+        std::string function;
+        unsigned parts;             // 0 for the functions without a table
+        double start;
+        double stop;
+        std::size_t samples;
+        double max_error;
+        double max_error_x;
+        double mean_error;
+        double rms_error;
+        std::size_t max_loops;
+        double mean_loops;
+        double ns_per_call;
+    };
+
+    struct domain {
+        const char* name;
+        double start;
+        double stop;
+        double (*reference)(double);
+    };
+
+    // the ranges of the plots
+    inline const std::vector<domain>& domains() {
+        static const std::vector<domain> list = {
+            {"cos", -10, 10, [](double x) {return std::cos(x);}},
+            {"sin", -10, 10, [](double x) {return std::sin(x);}},
+            {"sqrt", 0, 16, [](double x) {return std::sqrt(x);}},
+            {"asin", -1, 1, [](double x) {return std::asin(x);}},
+            {"log", 1e-3, 10, [](double x) {return std::log(x);}},
+            {"exp", -10, 10, [](double x) {return std::exp(x);}},
+            {"acos", -1, 1, [](double x) {return std::acos(x);}},
+            {"atan", -10, 10, [](double x) {return std::atan(x);}},
+            {"tan", -1.5, 1.5, [](double x) {return std::tan(x);}},
+            {"sinh", -5, 5, [](double x) {return std::sinh(x);}},
+            {"cosh", -5, 5, [](double x) {return std::cosh(x);}},
+            {"tanh", -5, 5, [](double x) {return std::tanh(x);}},
+        };
+        return list;
+    }
+
+    inline bool selected(const std::vector<std::string>& filter, const std::string& name) {
+        return filter.empty() || std::find(filter.begin(), filter.end(), name) != filter.end();
+    }
+
+
+    // monotonic integer keys of the representable values - the raw buffer or the ordered bits of IEEE754
+    template<typename T>
+    typename std::enable_if<fixedpoint_helpers::is_fixedpoint<T>::value, std::int64_t>::type to_key(T x) {
+        return (std::int64_t)x.getBuf();
+    }
+
+    template<typename T>
+    typename std::enable_if<fixedpoint_helpers::is_fixedpoint<T>::value, T>::type from_key(std::int64_t key) {
+        return T::buf_cast((decltype(T().getBuf()))key);
+    }
+
+    template<typename T>
+    using ieee_bits = typename std::conditional<sizeof(T) == 4, std::int32_t, std::int64_t>::type;
+
+    template<typename T>
+    typename std::enable_if<std::is_floating_point<T>::value, std::int64_t>::type to_key(T x) {
+        ieee_bits<T> bits;
+        std::memcpy(&bits, &x, sizeof(T));
+        return bits >= 0 ? (std::int64_t)bits : (std::int64_t)std::numeric_limits<ieee_bits<T>>::min() - bits;
+    }
+
+    template<typename T>
+    typename std::enable_if<std::is_floating_point<T>::value, T>::type from_key(std::int64_t key) {
+        ieee_bits<T> bits = (ieee_bits<T>)(key >= 0 ? key : (std::int64_t)std::numeric_limits<ieee_bits<T>>::min() - key);
+        T x;
+        std::memcpy(&x, &bits, sizeof(T));
+        return x;
+    }
+
+
+    template<typename T>
+    std::vector<T> arguments(double start, double stop, const config& cfg) {
+        std::vector<T> args;
+        if (cfg.mode == sampling::exhaustive) {
+            const std::int64_t first = to_key<T>(T(start));
+            const std::int64_t last = to_key<T>(T(stop));
+            const std::uint64_t count = (std::uint64_t)(last - first);
+            const std::uint64_t stride = count > cfg.samples ? (count + cfg.samples - 1) / cfg.samples : 1;
+            for (std::uint64_t i=0;i<count;i+=stride)
+                args.push_back(from_key<T>(first + (std::int64_t)i));
+        }
+        else {
+            for (std::size_t i=0;i<cfg.samples;i++)
+                args.push_back(T(start + i * (stop - start) / cfg.samples));
+        }
+        return args;
+    }
+
+
+    // evaluates fun on all arguments, the first call initializes the tables before the threads start
+    template<typename T>
+    std::vector<point> evaluate(const std::vector<T>& args, const std::function<T(T)>& fun, unsigned threads) {
+        std::vector<point> points(args.size());
+        if (args.empty())
+            return points;
+        fun(args[0]);
+        polyapprox_parallel::for_chunks(args.size(), threads, [&](unsigned, std::size_t begin, std::size_t end) {
+            for (std::size_t i=begin;i<end;i++) {
+                taylor::loop_counter = 0;
+                const T value = fun(args[i]);
+                points[i] = {(double)args[i], (double)value, taylor::loop_counter};
+            }
+        });
+        return points;
+    }
+
+    // the fastest of the repeated passes over the arguments
+    template<typename T>
+    double ns_per_call(const std::vector<T>& args, const std::function<T(T)>& fun, unsigned repeats) {
+        if (args.empty())
+            return 0;
+        double best = std::numeric_limits<double>::max();
+        for (unsigned r=0;r<repeats;r++) {
+            T sum = 0;
+            const auto t0 = std::chrono::steady_clock::now();
+            for (const T& x : args)
+                sum = fun(x) - sum;
+            const auto t1 = std::chrono::steady_clock::now();
+            asm volatile("" : : "r"(&sum) : "memory");
+            best = std::min(best, std::chrono::duration<double, std::nano>(t1 - t0).count() / args.size());
+        }
+        return best;
+    }
+
+    inline void statistics(const std::vector<point>& points, double (*reference)(double), result& r) {
+        r.samples = points.size();
+        r.max_error = r.max_error_x = r.mean_error = r.rms_error = r.mean_loops = 0;
+        r.max_loops = 0;
+        for (const auto& p : points) {
+            const double error = std::abs(p.y - reference(p.x));
+            if (!(error <= r.max_error)) {
+                r.max_error = error;
+                r.max_error_x = p.x;
+            }
+            r.mean_error += error;
+            r.rms_error += error * error;
+            r.max_loops = std::max(r.max_loops, p.loops);
+            r.mean_loops += p.loops;
+        }
+        if (!points.empty()) {
+            r.mean_error /= points.size();
+            r.rms_error = std::sqrt(r.rms_error / points.size());
+            r.mean_loops /= points.size();
+        }
+    }
+
+    inline bool write_points(const std::string& fileName, const std::vector<point>& points) {
+        std::ofstream file(fileName);
+        file << std::fixed << std::setw(32) << std::setprecision(32);
+        for (const auto& p : points)
+            file << p.x << "\t" << p.y << "\t" << p.loops << "\n";
+        return bool(file);
+    }
+
+
+    // a single function of a single type, run() samples, times and writes the plot file
+    struct sweep_case {
+        std::string type;
+        std::string group;
+        std::string function;
+        unsigned parts;
+        domain range;
+        std::function<result(const config&)> run;
+    };
+
+    template<typename T>
+    sweep_case make_case(const std::string& type, const std::string& group, unsigned parts, const domain& range, std::function<T(T)> fun) {
+        sweep_case c{type, group, range.name, parts, range, nullptr};
+        c.run = [=](const config& cfg) {
+            const std::vector<T> args = arguments<T>(range.start, range.stop, cfg);
+            const std::vector<point> points = evaluate<T>(args, fun, cfg.threads);
+            result r{type, group, range.name, parts, range.start, range.stop, 0, 0, 0, 0, 0, 0, 0, 0};
+            statistics(points, range.reference, r);
+            r.ns_per_call = ns_per_call<T>(args, fun, cfg.timing_repeats);
+            if (!cfg.plots_directory.empty())
+                write_points(cfg.plots_directory + "/" + type + "_" + group + "_" + range.name + ".txt", points);
+            return r;
+        };
+        return c;
+    }
+
+
+    template<typename T>
+    std::function<T(T)> taylor_function(const std::string& name) {
+        if (name == "cos") return taylor::cos<T>;
+        if (name == "sin") return taylor::sin<T>;
+        if (name == "sqrt") return taylor::sqrt<T>;
+        if (name == "asin") return taylor::asin<T>;
+        if (name == "log") return taylor::log<T>;
+        if (name == "exp") return taylor::exp<T>;
+        if (name == "acos") return taylor::acos<T>;
+        if (name == "atan") return taylor::atan<T>;
+        if (name == "tan") return taylor::tan<T>;
+        if (name == "sinh") return taylor::sinh<T>;
+        if (name == "cosh") return taylor::cosh<T>;
+        if (name == "tanh") return taylor::tanh<T>;
+        return nullptr;
+    }
+
+    template<typename T>
+    typename std::enable_if<std::is_floating_point<T>::value, std::function<T(T)>>::type std_function(const std::string& name) {
+        if (name == "cos") return [](T x) {return std::cos(x);};
+        if (name == "sin") return [](T x) {return std::sin(x);};
+        if (name == "sqrt") return [](T x) {return std::sqrt(x);};
+        if (name == "asin") return [](T x) {return std::asin(x);};
+        if (name == "log") return [](T x) {return std::log(x);};
+        if (name == "exp") return [](T x) {return std::exp(x);};
+        if (name == "acos") return [](T x) {return std::acos(x);};
+        if (name == "atan") return [](T x) {return std::atan(x);};
+        if (name == "tan") return [](T x) {return std::tan(x);};
+        if (name == "sinh") return [](T x) {return std::sinh(x);};
+        if (name == "cosh") return [](T x) {return std::cosh(x);};
+        if (name == "tanh") return [](T x) {return std::tanh(x);};
+        return nullptr;
+    }
+
+    template<typename T>
+    typename std::enable_if<!std::is_floating_point<T>::value, std::function<T(T)>>::type std_function(const std::string&) {
+        return nullptr;
+    }
+
+    // "std" (floating point only), "taylor" and "approx" cases of the selected functions,
+    // the group of PolyApprox is "approx" for a single part count and "approx<parts>" for more
+    template<typename T>
+    void add_type(std::vector<sweep_case>& cases, const std::string& type, const config& cfg) {
+        if (!selected(cfg.types, type))
+            return;
+        for (const domain& range : domains()) {
+            if (!selected(cfg.functions, range.name))
+                continue;
+            const auto std_fun = std_function<T>(range.name);
+            if (std_fun && selected(cfg.groups, "std"))
+                cases.push_back(make_case<T>(type, "std", 0, range, std_fun));
+            const auto taylor_fun = taylor_function<T>(range.name);
+            if (taylor_fun && selected(cfg.groups, "taylor"))
+                cases.push_back(make_case<T>(type, "taylor", 0, range, taylor_fun));
+            if (!selected(cfg.groups, "approx"))
+                continue;
+            for (unsigned parts : cfg.parts) {
+                const auto approx = PolyApprox<T>::template create<double>(range.reference, parts, range.start, range.stop, 1e-3, cfg.fit);
+                const std::string group = cfg.parts.size() == 1 ? "approx" : "approx" + std::to_string(parts);
+                cases.push_back(make_case<T>(type, group, parts, range, [approx](T x) {return approx(x);}));
+            }
+        }
+    }
+
+
+    inline std::vector<result> run(const std::vector<sweep_case>& cases, const config& cfg) {
+        std::vector<result> results;
+        for (const auto& c : cases)
+            results.push_back(c.run(cfg));
+        return results;
+    }
+
+    // one row per case, tab separated with a header
+    inline void write_results(std::ostream& out, const std::vector<result>& results) {
+        out << "type\tgroup\tfunction\tparts\tstart\tstop\tsamples\tmax_error\tmax_error_x\tmean_error\trms_error\tmax_loops\tmean_loops\tns_per_call\n";
+        out << std::setprecision(9);
+        for (const auto& r : results)
+            out << r.type << "\t" << r.group << "\t" << r.function << "\t" << r.parts << "\t" << r.start << "\t" << r.stop << "\t"
+                << r.samples << "\t" << r.max_error << "\t" << r.max_error_x << "\t" << r.mean_error << "\t" << r.rms_error << "\t"
+                << r.max_loops << "\t" << r.mean_loops << "\t" << r.ns_per_call << "\n";
+    }
+
+    inline bool write_results(const std::string& fileName, const std::vector<result>& results) {
+        std::ofstream file(fileName);
+        write_results(file, results);
+        return bool(file);
+    }
+
+}
+
+#endif
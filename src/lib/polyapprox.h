@@ -27,10 +27,18 @@
 #ifndef POLY_APPROX
 #define POLY_APPROX
 
+#include <cmath>
 #include <functional>
 #include <type_traits>
 #include <vector>
 #include <array>
+#include <utility>
+#include <limits>
+#include <cstdint>
+#include <cstddef>
+#include <new>
+
+#include "mathstats.h"
 
 
 namespace std {
@@ -39,6 +47,355 @@ namespace std {
 }
 
 
+#if __cplusplus >= 201703L
+#define POLYAPPROX_CONSTEXPR17 constexpr
+#else
+#define POLYAPPROX_CONSTEXPR17
+#endif
+
+#ifndef POLYAPPROX_BATCH_LANES
+#define POLYAPPROX_BATCH_LANES 8
+#endif
+
+
+// how the cubic of a part is fitted
+//   hermite   - values and derivatives at the ends of parts, the approximation is continuous
+//   chebyshev - least squares fit in the Chebyshev sense (truncated Chebyshev series of the part)
+//   minimax   - the smallest maximal error of the part (Remez exchange), small jumps between parts
+enum class PolyApproxFit {
+    hermite,
+    chebyshev,
+    minimax
+};
+
+
+namespace polyapprox_helpers {
+
+    constexpr static const unsigned batch_lanes = POLYAPPROX_BATCH_LANES;
+
+
+    template<typename T>
+    constexpr T abs(T x) {
+        return x < 0 ? -x : x;
+    }
+
+
+    template<typename T>
+    constexpr T max(T a, T b) {
+        return a > b ? a : b;
+    }
+
+
+    template<typename T>
+    constexpr T absmax(T a, T b) {
+        return max<T>(abs<T>(a), abs<T>(b));
+    }
+
+
+    template<typename T>
+    constexpr int sign(T x) {
+        return (x < 0) ? -1 : ((x > 0) ? 1 : 0);
+    }
+
+
+    // fixed point types - the value is a raw integer buffer with fraction_bits after the point
+    template<typename T>
+    struct has_raw_buffer {
+    private:
+        template<typename U>
+        static auto test(int) -> decltype(std::declval<U>().getBuf(), U::buf_cast(0), U::fraction_bits, std::true_type());
+
+        template<typename>
+        static std::false_type test(...);
+
+    public:
+        static constexpr const bool value = decltype(test<T>(0))::value;
+    };
+
+
+    template<typename T>
+    constexpr typename std::enable_if<has_raw_buffer<T>::value, int>::type min_width_log2() {
+        return -(int)T::fraction_bits;
+    }
+
+
+    template<typename T>
+    constexpr typename std::enable_if<!has_raw_buffer<T>::value, int>::type min_width_log2() {
+        return std::numeric_limits<T>::min_exponent;
+    }
+
+
+    // cubic hermite part between (x0, value0) and (x0 + inc, value1) as coefficients of t = x - x0
+    // derivatives (per unit of x) are limited with the value in the middle of the part to avoid overshoots
+    template <typename Calculable, typename Src>
+    POLYAPPROX_CONSTEXPR17 std::array<Calculable, 4> hermite_part(const Src& src, Calculable x0, Calculable inc,
+                                           Calculable value0, Calculable derivative0, Calculable value1, Calculable derivative1) {
+        constexpr const Calculable mid_der_k = Calculable(3) / 2;
+        Calculable inv_inc = Calculable(1) / inc;
+        Calculable inv_inc2 = inv_inc * inv_inc;
+        Calculable inv_inc3 = inv_inc2 * inv_inc;
+        Calculable v_mid = src(x0 + inc / 2);
+        Calculable vx = value1 - value0;
+        Calculable prev_deriverate = derivative0 * inc;
+        Calculable deriverate = derivative1 * inc;
+        Calculable max_prev_deriverate = 3 * absmax<Calculable>(mid_der_k * (v_mid - value0), vx);
+        Calculable max_deriverate = 3 * absmax<Calculable>(mid_der_k * (v_mid - value1), vx);
+        if (abs<Calculable>(prev_deriverate) > max_prev_deriverate)
+            prev_deriverate = max_prev_deriverate*sign<Calculable>(prev_deriverate);
+        if (abs<Calculable>(deriverate) > max_deriverate)
+            deriverate = max_deriverate*sign<Calculable>(deriverate);
+
+        std::array<Calculable, 4> coeffs{};
+        //              value           derivate at max     derivate at min
+        coeffs[3] = (   (-2) * vx       + deriverate        + prev_deriverate       ) * inv_inc3;
+        coeffs[2] = (   3 * vx          - deriverate        - 2 * prev_deriverate   ) * inv_inc2;
+        coeffs[1] = (                                       prev_deriverate         ) * inv_inc;
+        coeffs[0] =     value0;
+        return coeffs;
+    }
+
+
+    // fits parts between consecutive nodes, store(i, x0, coefficients) is called for every part
+    // derivatives are one sided at the first and the last node
+    template <typename Calculable, typename Store>
+    void fit_hermite(const std::function<Calculable(Calculable)>& src, const std::vector<Calculable>& nodes, Calculable dx, Store store) {
+        const unsigned part_count = nodes.size() - 1;
+        const Calculable inv_dx = Calculable(1) / dx;
+        const Calculable half_inv_dx = inv_dx / 2;
+        Calculable prev_value = src(nodes[0]);
+        Calculable prev_deriverate = (src(nodes[0]+dx) - prev_value) * inv_dx;
+        for (unsigned i=1;i<=part_count;i++) {
+            Calculable x = nodes[i];
+            Calculable value = src(x);
+            Calculable deriverate = (i<part_count) ? ((src(x+dx) - src(x-dx)) * half_inv_dx) : ((value - src(x-dx)) * inv_dx);
+            store(i-1, nodes[i-1], hermite_part<Calculable>(src, nodes[i-1], x - nodes[i-1], prev_value, prev_deriverate, value, deriverate));
+            prev_value = value;
+            prev_deriverate = deriverate;
+        }
+    }
+
+
+    // derivative at x from a central difference, one sided at the ends of the range
+    template <typename Calculable>
+    Calculable node_deriverate(const std::function<Calculable(Calculable)>& src, Calculable x, Calculable value, Calculable h, Calculable range_min, Calculable range_max) {
+        if (x - h < range_min) return (src(x+h) - value) / h;
+        if (x + h > range_max) return (value - src(x-h)) / h;
+        return (src(x+h) - src(x-h)) / (2 * h);
+    }
+
+
+    // maximal difference between the part and src sampled at 16 points
+    template <typename Calculable>
+    Calculable part_error(const std::function<Calculable(Calculable)>& src, Calculable x0, Calculable inc, const std::array<Calculable, 4>& coeffs) {
+        constexpr const unsigned samples = 16;
+        Calculable result = 0;
+        for (unsigned i=1;i<samples;i++) {
+            Calculable t = inc * i / samples;
+            Calculable y = ((coeffs[3] * t + coeffs[2]) * t + coeffs[1]) * t + coeffs[0];
+            result = max<Calculable>(result, abs<Calculable>(y - src(x0 + t)));
+        }
+        return result;
+    }
+
+
+    // the power of 2 not below bytes, at most a cache line - a part aligned to it does not cross a cache line if it fits into one
+    constexpr std::size_t part_alignment(std::size_t bytes, std::size_t alignment=1) {
+        return (alignment >= bytes || alignment >= 64) ? alignment : part_alignment(bytes, 2 * alignment);
+    }
+
+
+    // allocator of over-aligned parts - operator new aligns only to alignof(std::max_align_t) before C++17
+    template<typename T>
+    struct aligned_allocator {
+        using value_type = T;
+
+        aligned_allocator() = default;
+        template<typename U> aligned_allocator(const aligned_allocator<U>&) noexcept {}
+
+        T* allocate(std::size_t n) {
+            constexpr const std::size_t alignment = (alignof(T) > sizeof(void*)) ? alignof(T) : sizeof(void*);
+            char* raw = static_cast<char*>(::operator new(n * sizeof(T) + alignment + sizeof(void*)));
+            std::uintptr_t aligned = reinterpret_cast<std::uintptr_t>(raw + sizeof(void*));
+            aligned = (aligned + alignment - 1) / alignment * alignment;
+            reinterpret_cast<void**>(aligned)[-1] = raw;
+            return reinterpret_cast<T*>(aligned);
+        }
+
+        void deallocate(T* p, std::size_t) noexcept {
+            ::operator delete(reinterpret_cast<void**>(p)[-1]);
+        }
+
+        template<typename U> bool operator==(const aligned_allocator<U>&) const noexcept {return true;}
+        template<typename U> bool operator!=(const aligned_allocator<U>&) const noexcept {return false;}
+    };
+
+
+    // nodes of part_count parts of the width inc, the last node is range_max
+    template <typename Calculable>
+    std::vector<Calculable> uniform_nodes(unsigned part_count, Calculable range_min, Calculable range_max, Calculable inc) {
+        std::vector<Calculable> nodes(part_count + 1);
+        for (unsigned i=0;i<part_count;i++)
+            nodes[i] = range_min + i * inc;
+        nodes[part_count] = range_max;
+        return nodes;
+    }
+
+
+    // coefficients of t = (u + 1) * inc / 2 from coefficients of u in [-1, 1]
+    template <typename Calculable>
+    std::array<Calculable, 4> from_unit_interval(const std::array<Calculable, 4>& b, Calculable inc) {
+        // u = s * t - 1
+        const Calculable s = Calculable(2) / inc;
+        const Calculable s2 = s * s;
+        std::array<Calculable, 4> coeffs{};
+        coeffs[0] = b[0] - b[1] + b[2] - b[3];
+        coeffs[1] = (b[1] - 2 * b[2] + 3 * b[3]) * s;
+        coeffs[2] = (b[2] - 3 * b[3]) * s2;
+        coeffs[3] = b[3] * s2 * s;
+        return coeffs;
+    }
+
+
+    // truncated Chebyshev series of src on [x0, x0 + inc] from 16 Chebyshev nodes as coefficients of u in [-1, 1]
+    template <typename Calculable>
+    std::array<Calculable, 4> chebyshev_unit(const std::function<Calculable(Calculable)>& src, Calculable x0, Calculable inc) {
+        constexpr const unsigned nodes = 16;
+        const double pi = 3.14159265358979323846;
+        std::array<Calculable, 4> a{};
+        for (unsigned j=0;j<nodes;j++) {
+            const double angle = pi * (2 * j + 1) / (2 * nodes);
+            const Calculable y = src(x0 + (Calculable(std::cos(angle)) + 1) * inc / 2);
+            for (unsigned k=0;k<4;k++)
+                a[k] += y * Calculable(std::cos(k * angle));
+        }
+        for (unsigned k=0;k<4;k++)
+            a[k] = a[k] * 2 / nodes;
+        // T0 = 1, T1 = u, T2 = 2u^2 - 1, T3 = 4u^3 - 3u
+        return std::array<Calculable, 4>{{a[0] / 2 - a[2], a[1] - 3 * a[3], 2 * a[2], 4 * a[3]}};
+    }
+
+
+    // truncated Chebyshev series as coefficients of t = x - x0
+    template <typename Calculable>
+    std::array<Calculable, 4> chebyshev_part(const std::function<Calculable(Calculable)>& src, Calculable x0, Calculable inc) {
+        return from_unit_interval<Calculable>(chebyshev_unit<Calculable>(src, x0, inc), inc);
+    }
+
+
+    // solves the n x n system in place (Gauss elimination with partial pivoting)
+    template <typename Calculable, std::size_t n>
+    bool solve(std::array<std::array<Calculable, n + 1>, n>& m) {
+        for (std::size_t c=0;c<n;c++) {
+            std::size_t pivot = c;
+            for (std::size_t r=c+1;r<n;r++)
+                if (abs<Calculable>(m[r][c]) > abs<Calculable>(m[pivot][c])) pivot = r;
+            if (m[pivot][c] == Calculable(0)) return false;
+            std::swap(m[c], m[pivot]);
+            for (std::size_t r=0;r<n;r++) {
+                if (r == c) continue;
+                const Calculable k = m[r][c] / m[c][c];
+                for (std::size_t j=c;j<=n;j++)
+                    m[r][j] -= k * m[c][j];
+            }
+        }
+        for (std::size_t r=0;r<n;r++)
+            m[r][n] /= m[r][r];
+        return true;
+    }
+
+
+    // minimax cubic of src on [x0, x0 + inc] (Remez exchange on 128 samples) as coefficients of t = x - x0
+    template <typename Calculable>
+    std::array<Calculable, 4> minimax_part(const std::function<Calculable(Calculable)>& src, Calculable x0, Calculable inc) {
+        constexpr const unsigned samples = 128;
+        constexpr const unsigned iterations = 8;
+        const double pi = 3.14159265358979323846;
+        auto cubic = [](const std::array<Calculable, 4>& b, Calculable u) {return ((b[3] * u + b[2]) * u + b[1]) * u + b[0];};
+        auto f = [&](Calculable u) {return src(x0 + (u + 1) * inc / 2);};
+
+        std::array<Calculable, samples + 1> grid, values;
+        for (unsigned i=0;i<=samples;i++) {
+            grid[i] = Calculable(2) * i / samples - 1;
+            values[i] = f(grid[i]);
+        }
+
+        // the first reference - extrema of T4
+        std::array<Calculable, 5> reference;
+        for (unsigned i=0;i<5;i++)
+            reference[i] = -Calculable(std::cos(pi * i / 4));
+
+        // the Chebyshev fit is kept if the exchange does not improve it
+        std::array<Calculable, 4> best = chebyshev_unit<Calculable>(src, x0, inc);
+        Calculable best_error = 0;
+        for (unsigned i=0;i<=samples;i++)
+            best_error = max<Calculable>(best_error, abs<Calculable>(values[i] - cubic(best, grid[i])));
+
+        for (unsigned it=0;it<iterations;it++) {
+            // b0 + b1 u + b2 u^2 + b3 u^3 + (-1)^i E = f(u_i)
+            std::array<std::array<Calculable, 6>, 5> m;
+            for (unsigned i=0;i<5;i++) {
+                Calculable power = 1;
+                for (unsigned k=0;k<4;k++) {
+                    m[i][k] = power;
+                    power *= reference[i];
+                }
+                m[i][4] = (i % 2) ? -1 : 1;
+                m[i][5] = f(reference[i]);
+            }
+            if (!solve<Calculable, 5>(m)) break;
+            const std::array<Calculable, 4> b{{m[0][5], m[1][5], m[2][5], m[3][5]}};
+
+            // local extrema of the error with alternating signs
+            std::vector<Calculable> extrema_u, extrema_e;
+            for (unsigned i=0;i<=samples;i++) {
+                const Calculable e = values[i] - cubic(b, grid[i]);
+                if (!extrema_e.empty() && sign<Calculable>(e) == sign<Calculable>(extrema_e.back())) {
+                    if (abs<Calculable>(e) > abs<Calculable>(extrema_e.back())) {
+                        extrema_u.back() = grid[i];
+                        extrema_e.back() = e;
+                    }
+                } else if (e != Calculable(0)) {
+                    extrema_u.push_back(grid[i]);
+                    extrema_e.push_back(e);
+                }
+            }
+            Calculable error = 0;
+            for (Calculable e: extrema_e)
+                error = max<Calculable>(error, abs<Calculable>(e));
+            if (error < best_error) {
+                best = b;
+                best_error = error;
+            }
+            if (extrema_u.size() < 5) break;
+            // the smaller end is dropped, so the signs still alternate
+            std::size_t first = 0, last = extrema_u.size();
+            while (last - first > 5) {
+                if (abs<Calculable>(extrema_e[first]) < abs<Calculable>(extrema_e[last-1])) first++;
+                else last--;
+            }
+            for (unsigned i=0;i<5;i++)
+                reference[i] = extrema_u[first + i];
+        }
+        return from_unit_interval<Calculable>(best, inc);
+    }
+
+
+    // fits parts between consecutive nodes with the mode, store(i, x0, coefficients) is called for every part
+    template <typename Calculable, typename Store>
+    void fit_parts(const std::function<Calculable(Calculable)>& src, const std::vector<Calculable>& nodes, Calculable dx, PolyApproxFit mode, Store store) {
+        if (mode == PolyApproxFit::hermite) {
+            fit_hermite<Calculable>(src, nodes, dx, store);
+            return;
+        }
+        for (unsigned i=0;i+1<nodes.size();i++) {
+            const Calculable inc = nodes[i+1] - nodes[i];
+            store(i, nodes[i], (mode == PolyApproxFit::chebyshev) ? chebyshev_part<Calculable>(src, nodes[i], inc) : minimax_part<Calculable>(src, nodes[i], inc));
+        }
+    }
+
+}
+
+
 template <typename Storable, unsigned static_part_count = 0>
 class PolyApprox {
 
@@ -46,52 +403,84 @@ class PolyApprox {
 
         constexpr const static bool is_static = static_part_count > 0;
 
+        // coefficients of the static version - {c0, c1, c2, c3, x0} for every part
+        using table_type = std::array<std::array<Storable, 5>, static_part_count>;
+        using coefficients_type = typename std::conditional<is_static, table_type, std::vector<std::array<Storable, 5>>>::type;
+
         PolyApprox() = default;
         PolyApprox(const PolyApprox&) = default;
         PolyApprox(PolyApprox&&) = default;
 
 
+        // the table can be generated offline (see polyapprox_codegen.h) - a constexpr object is placed in read-only memory
+        constexpr PolyApprox(const coefficients_type& coefficients, Storable range_min, Storable inv_incrementator)
+            : coefficients(coefficients), range_min(range_min), inv_incrementator(inv_incrementator) {}
+
+
         template <typename Calculable, bool enable_part_count = !is_static, typename std::enable_if<enable_part_count, void>::type* = nullptr>
-        PolyApprox(const std::function<Calculable(Calculable)>& src, unsigned part_count, Calculable range_min, Calculable range_max, Calculable dx=1e-3) {
-            __fit<Calculable>(src, part_count, range_min, range_max, dx);
+        PolyApprox(const std::function<Calculable(Calculable)>& src, unsigned part_count, Calculable range_min, Calculable range_max, Calculable dx=1e-3, PolyApproxFit mode=PolyApproxFit::hermite) {
+            __fit<Calculable>(src, part_count, range_min, range_max, dx, mode);
         }
 
 
         template <typename Calculable, bool enable_part_count = !is_static, typename std::enable_if<!enable_part_count, void>::type* = nullptr>
-        PolyApprox(const std::function<Calculable(Calculable)>& src, Calculable range_min, Calculable range_max, Calculable dx=1e-3) {
-            __fit<Calculable>(src, static_part_count, range_min, range_max, dx);
+        PolyApprox(const std::function<Calculable(Calculable)>& src, Calculable range_min, Calculable range_max, Calculable dx=1e-3, PolyApproxFit mode=PolyApproxFit::hermite) {
+            __fit<Calculable>(src, static_part_count, range_min, range_max, dx, mode);
         }
 
 
         template <typename Calculable, bool enable_part_count = !is_static, typename std::enable_if<enable_part_count, void>::type* = nullptr>
-        static PolyApprox create(const std::function<Calculable(Calculable)>& src, unsigned part_count, Calculable range_min, Calculable range_max, Calculable dx=1e-3) {
-            return PolyApprox(src, part_count, range_min, range_max, dx);
+        static PolyApprox create(const std::function<Calculable(Calculable)>& src, unsigned part_count, Calculable range_min, Calculable range_max, Calculable dx=1e-3, PolyApproxFit mode=PolyApproxFit::hermite) {
+            return PolyApprox(src, part_count, range_min, range_max, dx, mode);
         }
 
 
         template <typename Calculable, bool enable_part_count = !is_static, typename std::enable_if<!enable_part_count, void>::type* = nullptr>
-        static PolyApprox create(const std::function<Calculable(Calculable)>& src, Calculable range_min, Calculable range_max, Calculable dx=1e-3) {
-            return PolyApprox(src, range_min, range_max, dx);
+        static PolyApprox create(const std::function<Calculable(Calculable)>& src, Calculable range_min, Calculable range_max, Calculable dx=1e-3, PolyApproxFit mode=PolyApproxFit::hermite) {
+            return PolyApprox(src, range_min, range_max, dx, mode);
         }
 
 
         template <typename Calculable, bool enable_part_count = !is_static, typename std::enable_if<enable_part_count, void>::type* = nullptr>
-        void fit(const std::function<Calculable(Calculable)>& src, unsigned part_count, Calculable range_min, Calculable range_max, Calculable dx=1e-3) {
-            __fit(src, part_count, range_min, range_max, dx);
+        void fit(const std::function<Calculable(Calculable)>& src, unsigned part_count, Calculable range_min, Calculable range_max, Calculable dx=1e-3, PolyApproxFit mode=PolyApproxFit::hermite) {
+            __fit(src, part_count, range_min, range_max, dx, mode);
         }
 
 
         template <typename Calculable, bool enable_part_count = !is_static, typename std::enable_if<!enable_part_count, void>::type* = nullptr>
-        void fit(const std::function<Calculable(Calculable)>& src, Calculable range_min, Calculable range_max, Calculable dx=1e-3) {
-            __fit(src, static_part_count, range_min, range_max, dx);
+        void fit(const std::function<Calculable(Calculable)>& src, Calculable range_min, Calculable range_max, Calculable dx=1e-3, PolyApproxFit mode=PolyApproxFit::hermite) {
+            __fit(src, static_part_count, range_min, range_max, dx, mode);
         }
 
 
+#if __cplusplus >= 201703L
+        // fitting at compile time - src has to be a constexpr functor (f.e. a lambda without captures)
+        template <typename Calculable, typename Src, bool enable_table = is_static, typename std::enable_if<enable_table, void>::type* = nullptr>
+        static constexpr PolyApprox fit_constexpr(const Src& src, Calculable range_min, Calculable range_max, Calculable dx=1e-3) {
+            table_type table{};
+            const Calculable inc = (range_max - range_min) / static_part_count;
+            Calculable prev_value = src(range_min);
+            Calculable prev_deriverate = (src(range_min+dx) - prev_value) / dx;
+            for (unsigned i=0;i<static_part_count;i++) {
+                Calculable x0 = range_min + i * inc;
+                Calculable x = (i+1 < static_part_count) ? x0 + inc : range_max;
+                Calculable value = src(x);
+                Calculable deriverate = (i+1 < static_part_count) ? ((src(x+dx) - src(x-dx)) / (2 * dx)) : ((value - src(x-dx)) / dx);
+                std::array<Calculable, 4> part = polyapprox_helpers::hermite_part<Calculable>(src, x0, x - x0, prev_value, prev_deriverate, value, deriverate);
+                for (unsigned j=0;j<4;j++)
+                    table[i][j] = Storable(part[j]);
+                table[i][4] = Storable(x0);
+                prev_value = value;
+                prev_deriverate = deriverate;
+            }
+            return PolyApprox(table, Storable(range_min), Storable(Calculable(1) / inc));
+        }
+#endif
+
+
         Storable call(Storable x) const noexcept {
-            unsigned part = std::floor((x - range_min) * inv_incrementator);
-            unsigned max_part = coefficients.size();
-            if (part >= max_part) part = max_part-1;
-            const auto& coeff = coefficients[part];
+            MATH_STATS_SCOPE("PolyApprox::call", Storable)
+            const auto& coeff = coefficients[part_index(x)];
             x -= coeff[4];
             return ((coeff[3] * x + coeff[2]) * x + coeff[1]) * x + coeff[0];
         }
@@ -102,6 +491,46 @@ class PolyApprox {
         }
 
 
+        // evaluates this and the second approximation with one index lookup
+        // second must be fitted with the same range and part count (f.e. sin and cos)
+        std::pair<Storable, Storable> call_pair(const PolyApprox& second, Storable x) const noexcept {
+            unsigned part = part_index(x);
+            const auto& coeff1 = coefficients[part];
+            const auto& coeff2 = second.coefficients[part];
+            x -= coeff1[4];
+            Storable y1 = coeff1[3] * x + coeff1[2];
+            Storable y2 = coeff2[3] * x + coeff2[2];
+            y1 = y1 * x + coeff1[1];
+            y2 = y2 * x + coeff2[1];
+            return std::make_pair(y1 * x + coeff1[0], y2 * x + coeff2[0]);
+        }
+
+
+        // evaluates n arguments in blocks of lanes: part indices, gathered coefficients, then Horner across the lanes
+        void call_batch(const Storable* in, Storable* out, std::size_t n) const noexcept {
+            constexpr const unsigned lanes = polyapprox_helpers::batch_lanes;
+            const std::size_t blocks_end = n - n % lanes;
+            for (std::size_t i=0;i<blocks_end;i+=lanes) {
+                unsigned part[lanes];
+                Storable c0[lanes], c1[lanes], c2[lanes], c3[lanes], t[lanes];
+                for (unsigned l=0;l<lanes;l++)
+                    part[l] = part_index(in[i+l]);
+                for (unsigned l=0;l<lanes;l++) {
+                    const auto& coeff = coefficients[part[l]];
+                    t[l] = in[i+l] - coeff[4];
+                    c0[l] = coeff[0];
+                    c1[l] = coeff[1];
+                    c2[l] = coeff[2];
+                    c3[l] = coeff[3];
+                }
+                for (unsigned l=0;l<lanes;l++)
+                    out[i+l] = ((c3[l] * t[l] + c2[l]) * t[l] + c1[l]) * t[l] + c0[l];
+            }
+            for (std::size_t i=blocks_end;i<n;i++)
+                out[i] = call(in[i]);
+        }
+
+
         template <typename Calculable>
         Calculable getMaxError(const std::function<Calculable(Calculable)>& fun, Calculable dx=1e-6) const {
             Calculable x = range_min;
@@ -110,7 +539,7 @@ class PolyApprox {
             while (x <= range_max) {
                 Calculable y1 = call(x);
                 Calculable y2 = fun(x);
-                Calculable diff = abs<Calculable>(y1 - y2);
+                Calculable diff = polyapprox_helpers::abs<Calculable>(y1 - y2);
                 if (diff > result)
                     result = diff;
                 x += dx;
@@ -119,44 +548,236 @@ class PolyApprox {
         }
 
 
+        unsigned getPartCount() const noexcept {
+            return coefficients.size();
+        }
+
+
+        // {c0, c1, c2, c3, x0} of the part
+        constexpr const std::array<Storable, 5>& getCoefficients(unsigned part) const noexcept {
+            return coefficients[part];
+        }
+
+
+        constexpr Storable getRangeMin() const noexcept {
+            return range_min;
+        }
+
+
+        constexpr Storable getInvIncrementator() const noexcept {
+            return inv_incrementator;
+        }
+
+
         PolyApprox& operator=(const PolyApprox&) = default;
         PolyApprox& operator=(PolyApprox&&) = default;
 
 
     private:
 
-        using static_coefficients = std::array<std::array<Storable, 5>, static_part_count>;
+        using static_coefficients = table_type;
         using dynamic_coefficients = std::vector<std::array<Storable, 5>>;
-        using coefficients_type = typename std::conditional<is_static, static_coefficients, dynamic_coefficients>::type;
 
         coefficients_type coefficients;
         Storable range_min;
         Storable inv_incrementator;
 
 
-        template<typename T>
-        static T abs(T x) {
-            return x < 0 ? -x : x;
+        unsigned part_index(Storable x) const noexcept {
+            unsigned part = std::floor((x - range_min) * inv_incrementator);
+            unsigned max_part = coefficients.size();
+            return (part < max_part) ? part : max_part-1;
         }
 
 
-        template<typename T>
-        static T max(T a, T b) {
-            return a > b ? a : b;
+        template<typename CT>
+        typename std::enable_if<std::is_same<CT, dynamic_coefficients>::value, void>::type 
+        resize_coefficients(unsigned new_size) {
+            coefficients.resize(new_size);
         }
+        
 
-                
-        template<typename T>
-        static T absmax(T a, T b) {
-            return max<T>(abs<T>(a), abs<T>(b));
+        template<typename CT>
+        typename std::enable_if<std::is_same<CT, static_coefficients>::value, void>::type 
+        resize_coefficients(unsigned) {}
+
+
+        template <typename Calculable>
+        void __fit(const std::function<Calculable(Calculable)>& src, unsigned part_count, Calculable range_min, Calculable range_max, Calculable dx=1e-3, PolyApproxFit mode=PolyApproxFit::hermite) {
+            Calculable inc = (range_max - range_min) / part_count;
+            this->range_min = range_min;
+            this->inv_incrementator = Calculable(1) / inc;
+            this->resize_coefficients<coefficients_type>(part_count);
+            polyapprox_helpers::fit_parts<Calculable>(src, polyapprox_helpers::uniform_nodes<Calculable>(part_count, range_min, range_max, inc), dx, mode,
+                [this](unsigned i, Calculable x0, const std::array<Calculable, 4>& part) {
+                    auto& coeffs = this->coefficients[i];
+                    coeffs[4] = x0;
+                    for (unsigned j=0;j<4;j++)
+                        coeffs[j] = part[j];
+                });
         }
 
+};
 
-        template<typename T>
-        static int sign(T x) {
-            if (x < 0) return -1;
-            if (x > 0) return 1;
-            return 0;
+
+// Parts have a width of a power of two - the part is found with a shift of the raw buffer (fixed point types)
+// or with a multiplication by an exact power of two (floating point types).
+// The beginning of a part is implied by its index, so the part stores only 4 coefficients (one cache line for 4 parts of 32 bit types).
+// part_count is the maximal number of parts - the width is rounded up to a power of two, so fewer parts may be used.
+template <typename Storable, unsigned static_part_count = 0>
+class ShiftPolyApprox {
+
+    public:
+
+        constexpr const static bool is_static = static_part_count > 0;
+
+        ShiftPolyApprox() = default;
+        ShiftPolyApprox(const ShiftPolyApprox&) = default;
+        ShiftPolyApprox(ShiftPolyApprox&&) = default;
+
+
+        template <typename Calculable, bool enable_part_count = !is_static, typename std::enable_if<enable_part_count, void>::type* = nullptr>
+        ShiftPolyApprox(const std::function<Calculable(Calculable)>& src, unsigned part_count, Calculable range_min, Calculable range_max, Calculable dx=1e-3, PolyApproxFit mode=PolyApproxFit::hermite) {
+            __fit<Calculable>(src, part_count, range_min, range_max, dx, mode);
+        }
+
+
+        template <typename Calculable, bool enable_part_count = !is_static, typename std::enable_if<!enable_part_count, void>::type* = nullptr>
+        ShiftPolyApprox(const std::function<Calculable(Calculable)>& src, Calculable range_min, Calculable range_max, Calculable dx=1e-3, PolyApproxFit mode=PolyApproxFit::hermite) {
+            __fit<Calculable>(src, static_part_count, range_min, range_max, dx, mode);
+        }
+
+
+        template <typename Calculable, bool enable_part_count = !is_static, typename std::enable_if<enable_part_count, void>::type* = nullptr>
+        static ShiftPolyApprox create(const std::function<Calculable(Calculable)>& src, unsigned part_count, Calculable range_min, Calculable range_max, Calculable dx=1e-3, PolyApproxFit mode=PolyApproxFit::hermite) {
+            return ShiftPolyApprox(src, part_count, range_min, range_max, dx, mode);
+        }
+
+
+        template <typename Calculable, bool enable_part_count = !is_static, typename std::enable_if<!enable_part_count, void>::type* = nullptr>
+        static ShiftPolyApprox create(const std::function<Calculable(Calculable)>& src, Calculable range_min, Calculable range_max, Calculable dx=1e-3, PolyApproxFit mode=PolyApproxFit::hermite) {
+            return ShiftPolyApprox(src, range_min, range_max, dx, mode);
+        }
+
+
+        template <typename Calculable, bool enable_part_count = !is_static, typename std::enable_if<enable_part_count, void>::type* = nullptr>
+        void fit(const std::function<Calculable(Calculable)>& src, unsigned part_count, Calculable range_min, Calculable range_max, Calculable dx=1e-3, PolyApproxFit mode=PolyApproxFit::hermite) {
+            __fit(src, part_count, range_min, range_max, dx, mode);
+        }
+
+
+        template <typename Calculable, bool enable_part_count = !is_static, typename std::enable_if<!enable_part_count, void>::type* = nullptr>
+        void fit(const std::function<Calculable(Calculable)>& src, Calculable range_min, Calculable range_max, Calculable dx=1e-3, PolyApproxFit mode=PolyApproxFit::hermite) {
+            __fit(src, static_part_count, range_min, range_max, dx, mode);
+        }
+
+
+        Storable call(Storable x) const noexcept {
+            MATH_STATS_SCOPE("ShiftPolyApprox::call", Storable)
+            Storable t;
+            const auto& coeff = coefficients[locate<Storable>(x - range_min, t)];
+            return ((coeff[3] * t + coeff[2]) * t + coeff[1]) * t + coeff[0];
+        }
+
+
+        Storable operator()(Storable x) const noexcept {
+            return call(x);
+        }
+
+
+        // evaluates n arguments in blocks of lanes: part indices, gathered coefficients, then Horner across the lanes
+        void call_batch(const Storable* in, Storable* out, std::size_t n) const noexcept {
+            constexpr const unsigned lanes = polyapprox_helpers::batch_lanes;
+            const std::size_t blocks_end = n - n % lanes;
+            for (std::size_t i=0;i<blocks_end;i+=lanes) {
+                unsigned part[lanes];
+                Storable c0[lanes], c1[lanes], c2[lanes], c3[lanes], t[lanes];
+                for (unsigned l=0;l<lanes;l++)
+                    part[l] = locate<Storable>(in[i+l] - range_min, t[l]);
+                for (unsigned l=0;l<lanes;l++) {
+                    const auto& coeff = coefficients[part[l]];
+                    c0[l] = coeff[0];
+                    c1[l] = coeff[1];
+                    c2[l] = coeff[2];
+                    c3[l] = coeff[3];
+                }
+                for (unsigned l=0;l<lanes;l++)
+                    out[i+l] = ((c3[l] * t[l] + c2[l]) * t[l] + c1[l]) * t[l] + c0[l];
+            }
+            for (std::size_t i=blocks_end;i<n;i++)
+                out[i] = call(in[i]);
+        }
+
+
+        // width of a part is 2^getWidthLog2()
+        int getWidthLog2() const noexcept {
+            return width_log2;
+        }
+
+
+        unsigned getPartCount() const noexcept {
+            return part_count;
+        }
+
+
+        template <typename Calculable>
+        Calculable getMaxError(const std::function<Calculable(Calculable)>& fun, Calculable dx=1e-6) const {
+            Calculable x = range_min;
+            Calculable result = 0;
+            while (x <= range_max) {
+                Calculable y1 = call(x);
+                Calculable y2 = fun(x);
+                Calculable diff = polyapprox_helpers::abs<Calculable>(y1 - y2);
+                if (diff > result)
+                    result = diff;
+                x += dx;
+            }
+            return result;
+        }
+
+
+        ShiftPolyApprox& operator=(const ShiftPolyApprox&) = default;
+        ShiftPolyApprox& operator=(ShiftPolyApprox&&) = default;
+
+
+    private:
+
+        using part_coefficients = std::array<Storable, 4>;
+        using static_coefficients = std::array<part_coefficients, static_part_count>;
+        using dynamic_coefficients = std::vector<part_coefficients>;
+        using coefficients_type = typename std::conditional<is_static, static_coefficients, dynamic_coefficients>::type;
+
+        coefficients_type coefficients;
+        Storable range_min;
+        Storable range_max;
+        Storable width;
+        Storable inv_width;
+        int width_log2;
+        unsigned index_shift;
+        unsigned part_count;
+
+
+        std::int64_t clamp_index(std::int64_t index) const noexcept {
+            index = (index < 0) ? 0 : index;
+            return (index < (std::int64_t)part_count) ? index : part_count - 1;
+        }
+
+
+        // part index and the offset from its beginning
+        template<typename T, typename std::enable_if<polyapprox_helpers::has_raw_buffer<T>::value, void>::type* = nullptr>
+        unsigned locate(T offset, T& t) const noexcept {
+            auto raw = offset.getBuf();
+            std::int64_t index = clamp_index((std::int64_t)(raw >> index_shift));
+            t = T::buf_cast(raw - ((decltype(raw))index << index_shift));
+            return index;
+        }
+
+
+        template<typename T, typename std::enable_if<!polyapprox_helpers::has_raw_buffer<T>::value, void>::type* = nullptr>
+        unsigned locate(T offset, T& t) const noexcept {
+            std::int64_t index = clamp_index((std::int64_t)(offset * inv_width));
+            t = offset - T(index) * width;
+            return index;
         }
 
 
@@ -172,52 +793,624 @@ class PolyApprox {
         resize_coefficients(unsigned) {}
 
 
+        template<typename T>
+        static typename std::enable_if<polyapprox_helpers::has_raw_buffer<T>::value, unsigned>::type fraction_bits() {
+            return T::fraction_bits;
+        }
+
+
+        template<typename T>
+        static typename std::enable_if<!polyapprox_helpers::has_raw_buffer<T>::value, unsigned>::type fraction_bits() {
+            return 0;
+        }
+
+
+        template <typename Calculable>
+        void __fit(const std::function<Calculable(Calculable)>& src, unsigned max_part_count, Calculable range_min, Calculable range_max, Calculable dx=1e-3, PolyApproxFit mode=PolyApproxFit::hermite) {
+            // the smallest power of two which covers the range with max_part_count parts
+            const Calculable range = range_max - range_min;
+            const int min_log2 = polyapprox_helpers::min_width_log2<Storable>();
+            Calculable inc = 1;
+            int inc_log2 = 0;
+            while (inc * max_part_count < range) {
+                inc *= 2;
+                inc_log2++;
+            }
+            while (inc_log2 > min_log2 && (inc / 2) * max_part_count >= range) {
+                inc /= 2;
+                inc_log2--;
+            }
+            unsigned used_part_count = 1;
+            while (used_part_count < max_part_count && used_part_count * inc < range)
+                used_part_count++;
+
+            this->range_min = range_min;
+            this->range_max = range_max;
+            this->width = inc;
+            this->inv_width = polyapprox_helpers::has_raw_buffer<Storable>::value ? Calculable(0) : Calculable(1) / inc;
+            this->width_log2 = inc_log2;
+            this->index_shift = fraction_bits<Storable>() + inc_log2;
+            this->part_count = used_part_count;
+            this->resize_coefficients<coefficients_type>(used_part_count);
+
+            // the last part ends on range_max
+            polyapprox_helpers::fit_parts<Calculable>(src, polyapprox_helpers::uniform_nodes<Calculable>(used_part_count, range_min, range_max, inc), dx, mode,
+                [this](unsigned i, Calculable, const std::array<Calculable, 4>& part) {
+                    for (unsigned j=0;j<4;j++)
+                        this->coefficients[i][j] = part[j];
+                });
+        }
+
+};
+
+
+// K functions fitted on the same parts (f.e. sin and cos, or a function and its derivative) - one index computation
+// and one fetch of the interleaved coefficients give all K values. Derivatives and integrals (from range_min)
+// are calculated from the cubics of the parts.
+// A part is padded and aligned to a power of 2 up to 64 bytes, so it is one cache line while 1 + 4K values fit into it
+// (K <= 3 for 4 byte types, K = 1 for 8 byte types) - larger parts take the smallest possible number of lines.
+template <typename Storable, unsigned K, unsigned static_part_count = 0>
+class MultiPolyApprox {
+
+    public:
+
+        constexpr const static bool is_static = static_part_count > 0;
+
+        using result_type = std::array<Storable, K>;
+        template <typename Calculable>
+        using sources_type = std::array<std::function<Calculable(Calculable)>, K>;
+
+        MultiPolyApprox() = default;
+        MultiPolyApprox(const MultiPolyApprox&) = default;
+        MultiPolyApprox(MultiPolyApprox&&) = default;
+
+
+        template <typename Calculable, bool enable_part_count = !is_static, typename std::enable_if<enable_part_count, void>::type* = nullptr>
+        MultiPolyApprox(const sources_type<Calculable>& src, unsigned part_count, Calculable range_min, Calculable range_max, Calculable dx=1e-3, PolyApproxFit mode=PolyApproxFit::hermite) {
+            __fit<Calculable>(src, part_count, range_min, range_max, dx, mode);
+        }
+
+
+        template <typename Calculable, bool enable_part_count = !is_static, typename std::enable_if<!enable_part_count, void>::type* = nullptr>
+        MultiPolyApprox(const sources_type<Calculable>& src, Calculable range_min, Calculable range_max, Calculable dx=1e-3, PolyApproxFit mode=PolyApproxFit::hermite) {
+            __fit<Calculable>(src, static_part_count, range_min, range_max, dx, mode);
+        }
+
+
+        template <typename Calculable, bool enable_part_count = !is_static, typename std::enable_if<enable_part_count, void>::type* = nullptr>
+        static MultiPolyApprox create(const sources_type<Calculable>& src, unsigned part_count, Calculable range_min, Calculable range_max, Calculable dx=1e-3, PolyApproxFit mode=PolyApproxFit::hermite) {
+            return MultiPolyApprox(src, part_count, range_min, range_max, dx, mode);
+        }
+
+
+        template <typename Calculable, bool enable_part_count = !is_static, typename std::enable_if<!enable_part_count, void>::type* = nullptr>
+        static MultiPolyApprox create(const sources_type<Calculable>& src, Calculable range_min, Calculable range_max, Calculable dx=1e-3, PolyApproxFit mode=PolyApproxFit::hermite) {
+            return MultiPolyApprox(src, range_min, range_max, dx, mode);
+        }
+
+
+        template <typename Calculable, bool enable_part_count = !is_static, typename std::enable_if<enable_part_count, void>::type* = nullptr>
+        void fit(const sources_type<Calculable>& src, unsigned part_count, Calculable range_min, Calculable range_max, Calculable dx=1e-3, PolyApproxFit mode=PolyApproxFit::hermite) {
+            __fit<Calculable>(src, part_count, range_min, range_max, dx, mode);
+        }
+
+
+        template <typename Calculable, bool enable_part_count = !is_static, typename std::enable_if<!enable_part_count, void>::type* = nullptr>
+        void fit(const sources_type<Calculable>& src, Calculable range_min, Calculable range_max, Calculable dx=1e-3, PolyApproxFit mode=PolyApproxFit::hermite) {
+            __fit<Calculable>(src, static_part_count, range_min, range_max, dx, mode);
+        }
+
+
+        result_type call(Storable x) const noexcept {
+            const auto& part = coefficients[part_index(x)];
+            const Storable t = x - part[0];
+            result_type result;
+            for (unsigned k=0;k<K;k++) {
+                const Storable* c = &part[1 + 4 * k];
+                result[k] = ((c[3] * t + c[2]) * t + c[1]) * t + c[0];
+            }
+            return result;
+        }
+
+
+        result_type operator()(Storable x) const noexcept {
+            return call(x);
+        }
+
+
+        result_type derivative(Storable x) const noexcept {
+            const auto& part = coefficients[part_index(x)];
+            const Storable t = x - part[0];
+            result_type result;
+            for (unsigned k=0;k<K;k++) {
+                const Storable* c = &part[1 + 4 * k];
+                result[k] = (Storable(3) * c[3] * t + Storable(2) * c[2]) * t + c[1];
+            }
+            return result;
+        }
+
+
+        // integrals of the approximations from range_min to x
+        result_type integral(Storable x) const noexcept {
+            const unsigned i = part_index(x);
+            const auto& part = coefficients[i];
+            const auto& sums = integrals[i];
+            const Storable t = x - part[0];
+            result_type result;
+            for (unsigned k=0;k<K;k++) {
+                const Storable* s = &sums[4 * k];
+                result[k] = (((s[2] * t + s[1]) * t + s[0]) * t + part[1 + 4 * k]) * t + s[3];
+            }
+            return result;
+        }
+
+
+        unsigned getPartCount() const noexcept {
+            return coefficients.size();
+        }
+
+
+        MultiPolyApprox& operator=(const MultiPolyApprox&) = default;
+        MultiPolyApprox& operator=(MultiPolyApprox&&) = default;
+
+
+    private:
+
+        // x0, then {c0, c1, c2, c3} of every function
+        struct alignas(polyapprox_helpers::part_alignment((1 + 4 * K) * sizeof(Storable))) part_coefficients : std::array<Storable, 1 + 4 * K> {};
+        // {c1 / 2, c2 / 3, c3 / 4, integral up to x0} of every function - apart from the values, used only by integral
+        using part_integrals = std::array<Storable, 4 * K>;
+        using static_coefficients = std::array<part_coefficients, static_part_count>;
+        using dynamic_coefficients = std::vector<part_coefficients, polyapprox_helpers::aligned_allocator<part_coefficients>>;
+        using coefficients_type = typename std::conditional<is_static, static_coefficients, dynamic_coefficients>::type;
+        using integrals_type = typename std::conditional<is_static, std::array<part_integrals, static_part_count>, std::vector<part_integrals>>::type;
+
+        coefficients_type coefficients;
+        integrals_type integrals;
+        Storable range_min;
+        Storable inv_incrementator;
+
+
+        unsigned part_index(Storable x) const noexcept {
+            std::int64_t part = std::floor((x - range_min) * inv_incrementator);
+            std::int64_t max_part = coefficients.size() - 1;
+            part = (part < 0) ? 0 : part;
+            return (part < max_part) ? part : max_part;
+        }
+
+
+        template<typename CT>
+        typename std::enable_if<std::is_same<CT, dynamic_coefficients>::value, void>::type
+        resize_coefficients(unsigned new_size) {
+            coefficients.resize(new_size);
+            integrals.resize(new_size);
+        }
+
+
+        template<typename CT>
+        typename std::enable_if<std::is_same<CT, static_coefficients>::value, void>::type
+        resize_coefficients(unsigned) {}
+
+
         template <typename Calculable>
-        void __fit(const std::function<Calculable(Calculable)>& src, unsigned part_count, Calculable range_min, Calculable range_max, Calculable dx=1e-3) {
-            
-            constexpr const Calculable mid_der_k = Calculable(3) / 2;
+        void __fit(const sources_type<Calculable>& src, unsigned part_count, Calculable range_min, Calculable range_max, Calculable dx, PolyApproxFit mode) {
             Calculable inc = (range_max - range_min) / part_count;
-            Calculable half_inc = inc / 2;
-            Calculable inv_inc = Calculable(1) / inc;
-            Calculable inv_inc2 = inv_inc * inv_inc;
-            Calculable inv_inc3 = inv_inc2 * inv_inc;
-            Calculable inc_idx = inc / dx;
-            Calculable half_inc_idx = inc_idx / 2;
             this->range_min = range_min;
-            this->inv_incrementator = inv_inc;
+            this->inv_incrementator = Calculable(1) / inc;
             this->resize_coefficients<coefficients_type>(part_count);
+            const std::vector<Calculable> nodes = polyapprox_helpers::uniform_nodes<Calculable>(part_count, range_min, range_max, inc);
+            for (unsigned k=0;k<K;k++) {
+                Calculable integral = 0;
+                polyapprox_helpers::fit_parts<Calculable>(src[k], nodes, dx, mode,
+                    [this, k, &nodes, &integral](unsigned i, Calculable x0, const std::array<Calculable, 4>& part) {
+                        auto& coeffs = this->coefficients[i];
+                        auto& sums = this->integrals[i];
+                        coeffs[0] = x0;
+                        for (unsigned j=0;j<4;j++)
+                            coeffs[1 + 4 * k + j] = part[j];
+                        for (unsigned j=0;j<3;j++)
+                            sums[4 * k + j] = part[j+1] / (j + 2);
+                        sums[4 * k + 3] = integral;
+                        const Calculable t = nodes[i+1] - x0;
+                        integral += (((part[3] / 4 * t + part[2] / 3) * t + part[1] / 2) * t + part[0]) * t;
+                    });
+            }
+        }
 
-            Calculable prev_value = src(range_min);
-            Calculable prev_deriverate = (src(range_min+dx) - prev_value) * inc_idx;
-            Calculable prev_x = range_min;
+};
 
-            for (unsigned i=1;i<=part_count;i++) {
-                Calculable x = range_min + i * inc;
-                Calculable value = src(x);
-                Calculable v_mid = src(x - half_inc);
-                Calculable new_deriverate = ((i<part_count) ? ((src(x+dx) - src(x-dx)) * half_inc_idx) : ((value - src(x-dx)) * inc_idx));
-                Calculable deriverate = new_deriverate;
-                Calculable vx = value - prev_value;
-                Calculable max_prev_deriverate = 3 * absmax<Calculable>(mid_der_k * (v_mid - prev_value), vx);
-                Calculable max_deriverate = 3 * absmax<Calculable>(mid_der_k * (v_mid - value), vx);
-                if (abs<Calculable>(prev_deriverate) > max_prev_deriverate)
-                    prev_deriverate = max_prev_deriverate*sign<Calculable>(prev_deriverate);
-                if (abs<Calculable>(deriverate) > max_deriverate)
-                    deriverate = max_deriverate*sign<Calculable>(deriverate);
-
-                auto& coeffs = this->coefficients[i-1];
-                coeffs[4] = prev_x;
-                //              value           derivate at max     derivate at min
-                coeffs[3] = (   (-2) * vx       + deriverate        + prev_deriverate       ) * inv_inc3;
-                coeffs[2] = (   3 * vx          - deriverate        - 2 * prev_deriverate   ) * inv_inc2;
-                coeffs[1] = (                                       prev_deriverate         ) * inv_inc;
-                coeffs[0] =     prev_value;
-
-                prev_x = x;
-                prev_value = value;
-                prev_deriverate = new_deriverate;
+
+// Approximation of a function of two variables on a uniform grid of bicubic Hermite patches.
+// Values and derivatives (f_x, f_y, f_xy) at the knots come from differences of src; f_x and f_y are limited
+// with the differences to the neighbour knots (like the derivatives of PolyApprox parts) to avoid overshoots.
+// Coefficients of a patch are stored for u, v in [0, 1) inside the patch, so they stay small for fixed point types.
+template <typename Storable, unsigned static_nx = 0, unsigned static_ny = 0>
+class PolyApprox2D {
+
+    public:
+
+        constexpr const static bool is_static = static_nx > 0 && static_ny > 0;
+
+        PolyApprox2D() = default;
+        PolyApprox2D(const PolyApprox2D&) = default;
+        PolyApprox2D(PolyApprox2D&&) = default;
+
+
+        template <typename Calculable, bool enable_part_count = !is_static, typename std::enable_if<enable_part_count, void>::type* = nullptr>
+        PolyApprox2D(const std::function<Calculable(Calculable, Calculable)>& src, unsigned nx, unsigned ny,
+                     Calculable x_min, Calculable x_max, Calculable y_min, Calculable y_max, Calculable dx=1e-3) {
+            __fit<Calculable>(src, nx, ny, x_min, x_max, y_min, y_max, dx);
+        }
+
+
+        template <typename Calculable, bool enable_part_count = !is_static, typename std::enable_if<!enable_part_count, void>::type* = nullptr>
+        PolyApprox2D(const std::function<Calculable(Calculable, Calculable)>& src,
+                     Calculable x_min, Calculable x_max, Calculable y_min, Calculable y_max, Calculable dx=1e-3) {
+            __fit<Calculable>(src, static_nx, static_ny, x_min, x_max, y_min, y_max, dx);
+        }
+
+
+        template <typename Calculable, bool enable_part_count = !is_static, typename std::enable_if<enable_part_count, void>::type* = nullptr>
+        static PolyApprox2D create(const std::function<Calculable(Calculable, Calculable)>& src, unsigned nx, unsigned ny,
+                                   Calculable x_min, Calculable x_max, Calculable y_min, Calculable y_max, Calculable dx=1e-3) {
+            return PolyApprox2D(src, nx, ny, x_min, x_max, y_min, y_max, dx);
+        }
+
+
+        template <typename Calculable, bool enable_part_count = !is_static, typename std::enable_if<!enable_part_count, void>::type* = nullptr>
+        static PolyApprox2D create(const std::function<Calculable(Calculable, Calculable)>& src,
+                                   Calculable x_min, Calculable x_max, Calculable y_min, Calculable y_max, Calculable dx=1e-3) {
+            return PolyApprox2D(src, x_min, x_max, y_min, y_max, dx);
+        }
+
+
+        Storable call(Storable x, Storable y) const noexcept {
+            Storable u, v;
+            const unsigned patch = locate(x, y, u, v);
+            return evaluate(coefficients[patch], u, v);
+        }
+
+
+        Storable operator()(Storable x, Storable y) const noexcept {
+            return call(x, y);
+        }
+
+
+        // evaluates n pairs of arguments in blocks of lanes: patches first, then the polynomials
+        void call_batch(const Storable* x, const Storable* y, Storable* out, std::size_t n) const noexcept {
+            constexpr const unsigned lanes = polyapprox_helpers::batch_lanes;
+            const std::size_t blocks_end = n - n % lanes;
+            for (std::size_t i=0;i<blocks_end;i+=lanes) {
+                unsigned patch[lanes];
+                Storable u[lanes], v[lanes];
+                for (unsigned l=0;l<lanes;l++)
+                    patch[l] = locate(x[i+l], y[i+l], u[l], v[l]);
+                for (unsigned l=0;l<lanes;l++)
+                    out[i+l] = evaluate(coefficients[patch[l]], u[l], v[l]);
             }
+            for (std::size_t i=blocks_end;i<n;i++)
+                out[i] = call(x[i], y[i]);
+        }
+
+
+        unsigned getPartCountX() const noexcept {
+            return nx;
+        }
+
+
+        unsigned getPartCountY() const noexcept {
+            return ny;
+        }
+
+
+        PolyApprox2D& operator=(const PolyApprox2D&) = default;
+        PolyApprox2D& operator=(PolyApprox2D&&) = default;
+
+
+    private:
+
+        // a[i][j] is the coefficient of u^i v^j, stored row by row
+        using patch_coefficients = std::array<Storable, 16>;
+        using static_coefficients = std::array<patch_coefficients, static_nx * static_ny>;
+        using dynamic_coefficients = std::vector<patch_coefficients>;
+        using coefficients_type = typename std::conditional<is_static, static_coefficients, dynamic_coefficients>::type;
+
+        coefficients_type coefficients;
+        Storable x_min;
+        Storable y_min;
+        Storable inv_inc_x;
+        Storable inv_inc_y;
+        unsigned nx;
+        unsigned ny;
+
+
+        static std::int64_t clamp_index(std::int64_t index, unsigned count) noexcept {
+            index = (index < 0) ? 0 : index;
+            return (index < (std::int64_t)count) ? index : count - 1;
+        }
+
+
+        unsigned locate(Storable x, Storable y, Storable& u, Storable& v) const noexcept {
+            const Storable sx = (x - x_min) * inv_inc_x;
+            const Storable sy = (y - y_min) * inv_inc_y;
+            const std::int64_t i = clamp_index((std::int64_t)std::floor(sx), nx);
+            const std::int64_t j = clamp_index((std::int64_t)std::floor(sy), ny);
+            u = sx - Storable(i);
+            v = sy - Storable(j);
+            return i * ny + j;
+        }
+
+
+        static Storable evaluate(const patch_coefficients& a, Storable u, Storable v) noexcept {
+            Storable rows[4];
+            for (unsigned i=0;i<4;i++)
+                rows[i] = ((a[4*i+3] * v + a[4*i+2]) * v + a[4*i+1]) * v + a[4*i];
+            return ((rows[3] * u + rows[2]) * u + rows[1]) * u + rows[0];
+        }
+
+
+        template<typename CT>
+        typename std::enable_if<std::is_same<CT, dynamic_coefficients>::value, void>::type
+        resize_coefficients(unsigned new_size) {
+            coefficients.resize(new_size);
+        }
+
+
+        template<typename CT>
+        typename std::enable_if<std::is_same<CT, static_coefficients>::value, void>::type
+        resize_coefficients(unsigned) {}
+
+
+        // derivative scaled by the width of the patch, limited by 3 times the larger difference to the neighbour knots
+        template <typename Calculable>
+        static Calculable limit_deriverate(Calculable deriverate, Calculable previous, Calculable value, Calculable next) {
+            const Calculable max_deriverate = 3 * polyapprox_helpers::absmax<Calculable>(value - previous, next - value);
+            return (polyapprox_helpers::abs<Calculable>(deriverate) > max_deriverate) ? max_deriverate * polyapprox_helpers::sign<Calculable>(deriverate) : deriverate;
+        }
+
+
+        template <typename Calculable>
+        void __fit(const std::function<Calculable(Calculable, Calculable)>& src, unsigned nx, unsigned ny,
+                   Calculable x_min, Calculable x_max, Calculable y_min, Calculable y_max, Calculable dx) {
+            const Calculable inc_x = (x_max - x_min) / nx;
+            const Calculable inc_y = (y_max - y_min) / ny;
+            this->x_min = x_min;
+            this->y_min = y_min;
+            this->inv_inc_x = Calculable(1) / inc_x;
+            this->inv_inc_y = Calculable(1) / inc_y;
+            this->nx = nx;
+            this->ny = ny;
+            this->resize_coefficients<coefficients_type>(nx * ny);
+
+            // knots (nx + 1) x (ny + 1): value, f_x * inc_x, f_y * inc_y, f_xy * inc_x * inc_y - differences are one sided at the borders
+            const unsigned kx = nx + 1, ky = ny + 1;
+            std::vector<Calculable> f(kx * ky), fx(kx * ky), fy(kx * ky), fxy(kx * ky);
+            auto knot_x = [&](unsigned i) {return (i < nx) ? x_min + i * inc_x : x_max;};
+            auto knot_y = [&](unsigned j) {return (j < ny) ? y_min + j * inc_y : y_max;};
+            for (unsigned i=0;i<kx;i++) {
+                const Calculable x = knot_x(i);
+                const Calculable xa = (i > 0) ? x - dx : x, xb = (i < nx) ? x + dx : x;
+                for (unsigned j=0;j<ky;j++) {
+                    const Calculable y = knot_y(j);
+                    const Calculable ya = (j > 0) ? y - dx : y, yb = (j < ny) ? y + dx : y;
+                    const unsigned k = i * ky + j;
+                    f[k] = src(x, y);
+                    fx[k] = (src(xb, y) - src(xa, y)) / (xb - xa) * inc_x;
+                    fy[k] = (src(x, yb) - src(x, ya)) / (yb - ya) * inc_y;
+                    fxy[k] = (src(xb, yb) - src(xb, ya) - src(xa, yb) + src(xa, ya)) / ((xb - xa) * (yb - ya)) * inc_x * inc_y;
+                }
+            }
+            for (unsigned i=0;i<kx;i++)
+                for (unsigned j=0;j<ky;j++) {
+                    const unsigned k = i * ky + j;
+                    fx[k] = limit_deriverate<Calculable>(fx[k], f[(i > 0) ? k - ky : k], f[k], f[(i < nx) ? k + ky : k]);
+                    fy[k] = limit_deriverate<Calculable>(fy[k], f[(j > 0) ? k - 1 : k], f[k], f[(j < ny) ? k + 1 : k]);
+                }
+
+            // a = M F M^T with F = {{f00, f01, fy00, fy01}, {f10, f11, fy10, fy11}, {fx00, fx01, fxy00, fxy01}, {fx10, fx11, fxy10, fxy11}}
+            const Calculable M[4][4] = {{1, 0, 0, 0}, {0, 0, 1, 0}, {-3, 3, -2, -1}, {2, -2, 1, 1}};
+            for (unsigned i=0;i<nx;i++)
+                for (unsigned j=0;j<ny;j++) {
+                    const unsigned k00 = i * ky + j, k01 = k00 + 1, k10 = k00 + ky, k11 = k10 + 1;
+                    const Calculable F[4][4] = {
+                        {f[k00], f[k01], fy[k00], fy[k01]},
+                        {f[k10], f[k11], fy[k10], fy[k11]},
+                        {fx[k00], fx[k01], fxy[k00], fxy[k01]},
+                        {fx[k10], fx[k11], fxy[k10], fxy[k11]}
+                    };
+                    Calculable MF[4][4];
+                    for (unsigned r=0;r<4;r++)
+                        for (unsigned c=0;c<4;c++) {
+                            MF[r][c] = 0;
+                            for (unsigned m=0;m<4;m++)
+                                MF[r][c] += M[r][m] * F[m][c];
+                        }
+                    auto& a = coefficients[i * ny + j];
+                    for (unsigned r=0;r<4;r++)
+                        for (unsigned c=0;c<4;c++) {
+                            Calculable value = 0;
+                            for (unsigned m=0;m<4;m++)
+                                value += MF[r][m] * M[c][m];
+                            a[4*r+c] = value;
+                        }
+                }
+        }
+
+};
+
+
+// Parts are split in halves only where the error of the part is above max_error, so steep regions (f.e. log near 0, asin near 1)
+// do not dictate the width of all parts. The part is found with a branchless search of the knots stored in the Eytzinger (BFS) order.
+template <typename Storable>
+class AdaptivePolyApprox {
+
+    public:
+
+        // maximal number of halvings of the range
+        constexpr const static unsigned max_split_depth = 32;
+
+        AdaptivePolyApprox() = default;
+        AdaptivePolyApprox(const AdaptivePolyApprox&) = default;
+        AdaptivePolyApprox(AdaptivePolyApprox&&) = default;
+
+
+        template <typename Calculable>
+        AdaptivePolyApprox(const std::function<Calculable(Calculable)>& src, Calculable max_error, Calculable range_min, Calculable range_max, Calculable dx=1e-3) {
+            __fit<Calculable>(src, max_error, range_min, range_max, dx);
+        }
+
+
+        template <typename Calculable>
+        static AdaptivePolyApprox create(const std::function<Calculable(Calculable)>& src, Calculable max_error, Calculable range_min, Calculable range_max, Calculable dx=1e-3) {
+            return AdaptivePolyApprox(src, max_error, range_min, range_max, dx);
+        }
+
+
+        template <typename Calculable>
+        void fit(const std::function<Calculable(Calculable)>& src, Calculable max_error, Calculable range_min, Calculable range_max, Calculable dx=1e-3) {
+            __fit(src, max_error, range_min, range_max, dx);
+        }
+
+
+        Storable call(Storable x) const noexcept {
+            MATH_STATS_SCOPE("AdaptivePolyApprox::call", Storable)
+            const auto& coeff = coefficients[part_index(x)];
+            x -= coeff[4];
+            return ((coeff[3] * x + coeff[2]) * x + coeff[1]) * x + coeff[0];
+        }
+
+
+        Storable operator()(Storable x) const noexcept {
+            return call(x);
+        }
+
+
+        unsigned getPartCount() const noexcept {
+            return coefficients.size();
+        }
+
+
+        template <typename Calculable>
+        Calculable getMaxError(const std::function<Calculable(Calculable)>& fun, Calculable dx=1e-6) const {
+            Calculable x = range_min;
+            Calculable result = 0;
+            while (x <= range_max) {
+                Calculable y1 = call(x);
+                Calculable y2 = fun(x);
+                Calculable diff = polyapprox_helpers::abs<Calculable>(y1 - y2);
+                if (diff > result)
+                    result = diff;
+                x += dx;
+            }
+            return result;
+        }
+
+
+        AdaptivePolyApprox& operator=(const AdaptivePolyApprox&) = default;
+        AdaptivePolyApprox& operator=(AdaptivePolyApprox&&) = default;
+
+
+    private:
+
+        std::vector<std::array<Storable, 5>> coefficients;
+        // knots in the Eytzinger order (from index 1), padded with the maximal value to 2^tree_depth - 1 elements
+        std::vector<Storable> tree;
+        // part of the knot, tree_part[0] is used for arguments below the first knot
+        std::vector<unsigned> tree_part;
+        unsigned tree_depth;
+        Storable range_min;
+        Storable range_max;
+
+
+        // the last knot not greater than x - the same number of steps for every argument
+        unsigned part_index(Storable x) const noexcept {
+            std::size_t i = 1;
+            std::size_t found = 0;
+            MATH_STATS_ITERATIONS(tree_depth);
+            for (unsigned d=0;d<tree_depth;d++) {
+                bool right = tree[i] <= x;
+                found = right ? i : found;
+                i = 2 * i + right;
+            }
+            return tree_part[found];
+        }
+
+
+        void build_tree(std::size_t i, unsigned& k) {
+            if (i >= tree.size()) return;
+            build_tree(2 * i, k);
+            bool padding = k >= coefficients.size();
+            tree[i] = padding ? std::numeric_limits<Storable>::max() : coefficients[k][4];
+            tree_part[i] = padding ? coefficients.size() - 1 : k;
+            k++;
+            build_tree(2 * i + 1, k);
+        }
+
+
+        template <typename Calculable>
+        static bool representable(const std::array<Calculable, 4>& part) {
+            const Calculable limit = (Calculable)std::numeric_limits<Storable>::max() / 2;
+            for (unsigned j=0;j<4;j++)
+                if (!(polyapprox_helpers::abs<Calculable>(part[j]) < limit)) return false;
+            return true;
+        }
+
+
+        template <typename Calculable>
+        void store_part(Calculable x0, const std::array<Calculable, 4>& part) {
+            std::array<Storable, 5> coeffs;
+            for (unsigned j=0;j<4;j++)
+                coeffs[j] = part[j];
+            coeffs[4] = x0;
+            coefficients.push_back(coeffs);
+        }
+
+
+        template <typename Calculable>
+        void fit_part(const std::function<Calculable(Calculable)>& src, Calculable max_error, Calculable dx, Calculable range_min, Calculable range_max,
+                      Calculable a, Calculable value_a, Calculable deriverate_a,
+                      Calculable b, Calculable value_b, Calculable deriverate_b, unsigned depth) {
+            std::array<Calculable, 4> part = polyapprox_helpers::hermite_part<Calculable>(src, a, b - a, value_a, deriverate_a, value_b, deriverate_b);
+            Calculable m = (a + b) / 2;
+            bool splittable = depth < max_split_depth && Storable(a) < Storable(m) && Storable(m) < Storable(b);
+            if (!splittable || !(polyapprox_helpers::part_error<Calculable>(src, a, b - a, part) > max_error)) {
+                store_part<Calculable>(a, part);
+                return;
+            }
+            // the step of the derivative is limited by the width, the derivative is shared by both halves
+            Calculable h = (b - a) / 4;
+            h = (h < dx) ? h : dx;
+            Calculable value_m = src(m);
+            Calculable deriverate_m = polyapprox_helpers::node_deriverate<Calculable>(src, m, value_m, h, range_min, range_max);
+            // coefficients of short parts grow with 1/width^3 - fixed point types keep the longer part
+            if (!representable<Calculable>(polyapprox_helpers::hermite_part<Calculable>(src, a, m - a, value_a, deriverate_a, value_m, deriverate_m)) ||
+                !representable<Calculable>(polyapprox_helpers::hermite_part<Calculable>(src, m, b - m, value_m, deriverate_m, value_b, deriverate_b))) {
+                store_part<Calculable>(a, part);
+                return;
+            }
+            fit_part<Calculable>(src, max_error, dx, range_min, range_max, a, value_a, deriverate_a, m, value_m, deriverate_m, depth + 1);
+            fit_part<Calculable>(src, max_error, dx, range_min, range_max, m, value_m, deriverate_m, b, value_b, deriverate_b, depth + 1);
+        }
+
+
+        template <typename Calculable>
+        void __fit(const std::function<Calculable(Calculable)>& src, Calculable max_error, Calculable range_min, Calculable range_max, Calculable dx=1e-3) {
+            this->range_min = range_min;
+            this->range_max = range_max;
+            coefficients.clear();
+            Calculable value_min = src(range_min);
+            Calculable value_max = src(range_max);
+            fit_part<Calculable>(src, max_error, dx, range_min, range_max,
+                range_min, value_min, polyapprox_helpers::node_deriverate<Calculable>(src, range_min, value_min, dx, range_min, range_max),
+                range_max, value_max, polyapprox_helpers::node_deriverate<Calculable>(src, range_max, value_max, dx, range_min, range_max), 0);
 
+            tree_depth = 0;
+            while (((std::size_t)1 << tree_depth) - 1 < coefficients.size())
+                tree_depth++;
+            tree.assign((std::size_t)1 << tree_depth, Storable(0));
+            tree_part.assign((std::size_t)1 << tree_depth, 0);
+            unsigned k = 0;
+            build_tree(1, k);
         }
 
 };
@@ -0,0 +1,107 @@
+/****************************************************************************************
+
+                                       MIT License
+
+               Copyright (c) 2025 Pawel Bielecki [pbielecki2000@gmail.com]
+
+       Permission is hereby granted, free of charge, to any person obtaining a copy
+      of this software and associated documentation files (the "Software"), to deal
+       in the Software without restriction, including without limitation the rights
+        to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+          copies of the Software, and to permit persons to whom the Software is
+                 furnished to do so, subject to the following conditions:
+
+      The above copyright notice and this permission notice shall be included in all
+                     copies or substantial portions of the Software.
+
+        THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+         IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+       FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+          AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+      LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+      OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+                                        SOFTWARE.
+
+****************************************************************************************/
+
+
+#ifndef POLY_APPROX_CODEGEN
+#define POLY_APPROX_CODEGEN
+
+#include <ostream>
+#include <ios>
+#include <string>
+#include <limits>
+#include <type_traits>
+
+#include "polyapprox.h"
+
+
+// Emits a header with a constexpr PolyApprox table - the fitting is done offline and the table lives in read-only memory.
+namespace polyapprox_codegen {
+
+    // exact literals - the raw buffer of fixed point types, max_digits10 digits of floating point types
+    template<typename T, typename std::enable_if<polyapprox_helpers::has_raw_buffer<T>::value, void>::type* = nullptr>
+    void write_literal(std::ostream& out, const T& value, const std::string& type_name) {
+        out << type_name << "::buf_cast(" << +value.getBuf() << ")";
+    }
+
+
+    template<typename T, typename std::enable_if<!polyapprox_helpers::has_raw_buffer<T>::value, void>::type* = nullptr>
+    void write_literal(std::ostream& out, const T& value, const std::string&) {
+        std::streamsize precision = out.precision(std::numeric_limits<T>::max_digits10 - 1);
+        std::ios_base::fmtflags flags = out.setf(std::ios_base::scientific, std::ios_base::floatfield);
+        out << value;
+        if (std::is_same<T, float>::value) out << "f";
+        if (std::is_same<T, long double>::value) out << "L";
+        out.precision(precision);
+        out.flags(flags);
+    }
+
+
+    // the constexpr definition alone - for headers which hold more tables
+    template<typename Storable, unsigned static_part_count>
+    void writeTable(std::ostream& out, const PolyApprox<Storable, static_part_count>& approx, const std::string& name, const std::string& type_name,
+                    const std::string& indent="") {
+        const unsigned part_count = approx.getPartCount();
+        const std::string approx_type = "PolyApprox<" + type_name + ", " + std::to_string(part_count) + ">";
+
+        out << indent << "constexpr " << approx_type << " " << name << "(\n";
+        out << indent << "    " << approx_type << "::table_type{{\n";
+        for (unsigned i=0;i<part_count;i++) {
+            const auto& coeffs = approx.getCoefficients(i);
+            out << indent << "        {{";
+            for (unsigned j=0;j<5;j++) {
+                if (j) out << ", ";
+                write_literal<Storable>(out, coeffs[j], type_name);
+            }
+            out << ((i+1 < part_count) ? "}},\n" : "}}\n");
+        }
+        out << indent << "    }},\n" << indent << "    ";
+        write_literal<Storable>(out, approx.getRangeMin(), type_name);
+        out << ",\n" << indent << "    ";
+        write_literal<Storable>(out, approx.getInvIncrementator(), type_name);
+        out << "\n" << indent << ");\n";
+    }
+
+
+    // type_name is the spelling of Storable in the header (f.e. "fixed32"), the header includes fixedpoint.h for fixed point types
+    template<typename Storable, unsigned static_part_count>
+    void toHeader(std::ostream& out, const PolyApprox<Storable, static_part_count>& approx, const std::string& name, const std::string& type_name) {
+        std::string guard = name;
+        for (auto& c: guard)
+            c = (c >= 'a' && c <= 'z') ? c - 'a' + 'A' : c;
+
+        out << "// generated by polyapprox_codegen.h\n\n";
+        out << "#ifndef POLY_APPROX_TABLE_" << guard << "\n";
+        out << "#define POLY_APPROX_TABLE_" << guard << "\n\n";
+        if (polyapprox_helpers::has_raw_buffer<Storable>::value)
+            out << "#include \"fixedpoint.h\"\n";
+        out << "#include \"polyapprox.h\"\n\n";
+        writeTable(out, approx, name, type_name);
+        out << "\n#endif\n";
+    }
+
+}
+
+#endif
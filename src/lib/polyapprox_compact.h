@@ -0,0 +1,444 @@
+/****************************************************************************************
+
+                                       MIT License
+
+               Copyright (c) 2025 Pawel Bielecki [pbielecki2000@gmail.com]
+
+       Permission is hereby granted, free of charge, to any person obtaining a copy
+      of this software and associated documentation files (the "Software"), to deal
+       in the Software without restriction, including without limitation the rights
+        to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+          copies of the Software, and to permit persons to whom the Software is
+                 furnished to do so, subject to the following conditions:
+
+      The above copyright notice and this permission notice shall be included in all
+                     copies or substantial portions of the Software.
+
+        THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+         IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+       FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+          AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+      LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+      OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+                                        SOFTWARE.
+
+****************************************************************************************/
+
+#ifndef POLY_APPROX_COMPACT
+#define POLY_APPROX_COMPACT
+
+#include <cmath>
+#include <vector>
+#include <array>
+#include <limits>
+#include <cstdint>
+#include <cstddef>
+#include <functional>
+#include <type_traits>
+
+#include "polyapprox.h"
+
+
+// Fixed point approximation with narrow coefficients - for tables which have to fit in the cache (or in a small flash).
+// Parts have a width of a power of two like in ShiftPolyApprox. The value at the beginning of the part is stored in full,
+// the higher coefficients as Coef (int16_t or int8_t) with a shared exponent of the part.
+// The polynomial is evaluated in integers on t / width in [0, 1) - a constant shift per Horner step, the alignment of t
+// to the width of the table and the final shift by the exponent of the part are runtime values.
+// Arguments outside the range are clamped to it.
+template <typename Fixed, typename Coef = std::int16_t>
+class CompactPolyApprox {
+
+    static_assert(polyapprox_helpers::has_raw_buffer<Fixed>::value, "CompactPolyApprox works with fixed point types");
+    static_assert(std::is_integral<Coef>::value && std::is_signed<Coef>::value && sizeof(Coef) <= 4, "Coef must be a signed integer of at most 32 bits");
+
+    public:
+
+        using raw_type = decltype(std::declval<Fixed>().getBuf());
+
+        // value at the beginning, c1..c3 scaled by 2^exponent, for the variable t / width
+        struct part {
+            raw_type c0;
+            Coef c[3];
+            std::int8_t exponent;
+        };
+
+        CompactPolyApprox() = default;
+        CompactPolyApprox(const CompactPolyApprox&) = default;
+        CompactPolyApprox(CompactPolyApprox&&) = default;
+
+
+        template <typename Calculable>
+        CompactPolyApprox(const std::function<Calculable(Calculable)>& src, unsigned part_count, Calculable range_min, Calculable range_max, Calculable dx=1e-3) {
+            __fit<Calculable>(src, part_count, range_min, range_max, dx);
+        }
+
+
+        template <typename Calculable>
+        static CompactPolyApprox create(const std::function<Calculable(Calculable)>& src, unsigned part_count, Calculable range_min, Calculable range_max, Calculable dx=1e-3) {
+            return CompactPolyApprox(src, part_count, range_min, range_max, dx);
+        }
+
+
+        template <typename Calculable>
+        void fit(const std::function<Calculable(Calculable)>& src, unsigned part_count, Calculable range_min, Calculable range_max, Calculable dx=1e-3) {
+            __fit<Calculable>(src, part_count, range_min, range_max, dx);
+        }
+
+
+        Fixed call(Fixed x) const noexcept {
+            std::int64_t offset = (std::int64_t)x.getBuf() - range_min;
+            offset = (offset < 0) ? 0 : ((offset > range_raw) ? range_raw : offset);
+            std::int64_t index = offset >> index_shift;
+            index = (index < last_part) ? index : last_part;
+            const part& p = parts[index];
+            const std::int64_t t = ((offset - (index << index_shift)) << variable_left) >> variable_right;
+            std::int64_t acc = p.c[2];
+            acc = ((acc * t + round) >> variable_bits) + p.c[1];
+            acc = ((acc * t + round) >> variable_bits) + p.c[0];
+            acc = (acc * t + round) >> variable_bits;
+            return Fixed::buf_cast((raw_type)(p.c0 + final_shift<right_shift_only>(acc, p.exponent - (int)Fixed::fraction_bits)));
+        }
+
+
+        Fixed operator()(Fixed x) const noexcept {
+            return call(x);
+        }
+
+
+        // width of a part is 2^getWidthLog2()
+        int getWidthLog2() const noexcept {
+            return (int)index_shift - (int)Fixed::fraction_bits;
+        }
+
+
+        unsigned getPartCount() const noexcept {
+            return parts.size();
+        }
+
+
+        const part& getPart(unsigned i) const noexcept {
+            return parts[i];
+        }
+
+
+        // memory used by the coefficients
+        std::size_t getTableBytes() const noexcept {
+            return parts.size() * sizeof(part);
+        }
+
+
+        template <typename Calculable>
+        Calculable getMaxError(const std::function<Calculable(Calculable)>& fun, Calculable dx=1e-6) const {
+            Calculable x = Fixed::buf_cast(range_min);
+            Calculable range_max = Fixed::buf_cast(range_min + range_raw);
+            Calculable result = 0;
+            while (x <= range_max) {
+                Calculable diff = polyapprox_helpers::abs<Calculable>(Calculable(call(x)) - fun(x));
+                if (diff > result)
+                    result = diff;
+                x += dx;
+            }
+            return result;
+        }
+
+
+        CompactPolyApprox& operator=(const CompactPolyApprox&) = default;
+        CompactPolyApprox& operator=(CompactPolyApprox&&) = default;
+
+
+    private:
+
+        // t / width has variable_bits fraction bits - a constant, so the products of Horner steps fit in 64 bits and their shifts are immediate
+        constexpr static const unsigned variable_bits = 60 - 8 * sizeof(Coef);
+        constexpr static const std::int64_t round = (std::int64_t)1 << (variable_bits - 1);
+        // coefficients as wide as the buffer hold any value with the fraction bits, so the exponent is never below them
+        constexpr static const bool right_shift_only = sizeof(Coef) >= sizeof(raw_type);
+        constexpr static const int min_exponent = right_shift_only ? (int)Fixed::fraction_bits : (int)Fixed::fraction_bits - 24;
+
+        std::vector<part> parts;
+        std::int64_t range_min = 0;
+        std::int64_t range_raw = 0;
+        unsigned index_shift = 0;
+        std::int64_t last_part = 0;
+        unsigned variable_left = 0;
+        unsigned variable_right = 0;
+
+
+        template<bool right_only>
+        static typename std::enable_if<right_only, std::int64_t>::type final_shift(std::int64_t acc, int shift) noexcept {
+            return (acc + (((std::int64_t)1 << shift) >> 1)) >> shift;
+        }
+
+
+        template<bool right_only>
+        static typename std::enable_if<!right_only, std::int64_t>::type final_shift(std::int64_t acc, int shift) noexcept {
+            return (shift > 0) ? ((acc + ((std::int64_t)1 << (shift - 1))) >> shift) : (acc * ((std::int64_t)1 << -shift));
+        }
+
+
+        // the largest exponent with all coefficients in Coef, limited so the final shift stays in 64 bits
+        static int coefficient_exponent(const std::array<double, 3>& coeffs) {
+            const double limit = std::numeric_limits<Coef>::max();
+            double largest = 0;
+            for (double c: coeffs)
+                largest = polyapprox_helpers::max<double>(largest, polyapprox_helpers::abs<double>(c));
+            int exponent = (int)Fixed::fraction_bits + 48;
+            while (exponent > min_exponent && std::round(largest * std::ldexp(1.0, exponent)) > limit)
+                exponent--;
+            return exponent;
+        }
+
+
+        static Coef saturate(double value) {
+            const double rounded = std::round(value);
+            if (rounded > std::numeric_limits<Coef>::max()) return std::numeric_limits<Coef>::max();
+            if (rounded < std::numeric_limits<Coef>::min()) return std::numeric_limits<Coef>::min();
+            return (Coef)rounded;
+        }
+
+
+        template <typename Calculable>
+        void __fit(const std::function<Calculable(Calculable)>& src, unsigned max_part_count, Calculable range_min, Calculable range_max, Calculable dx=1e-3) {
+            // the smallest power of two which covers the range with max_part_count parts
+            const Calculable range = range_max - range_min;
+            Calculable inc = 1;
+            int inc_log2 = 0;
+            while (inc * max_part_count < range) {
+                inc *= 2;
+                inc_log2++;
+            }
+            while (inc_log2 > -(int)Fixed::fraction_bits && (inc / 2) * max_part_count >= range) {
+                inc /= 2;
+                inc_log2--;
+            }
+            unsigned used_part_count = 1;
+            while (used_part_count < max_part_count && used_part_count * inc < range)
+                used_part_count++;
+
+            this->range_min = Fixed(range_min).getBuf();
+            this->range_raw = (std::int64_t)Fixed(range_max).getBuf() - this->range_min;
+            this->index_shift = Fixed::fraction_bits + inc_log2;
+            this->variable_left = (index_shift < variable_bits) ? variable_bits - index_shift : 0;
+            this->variable_right = (index_shift > variable_bits) ? index_shift - variable_bits : 0;
+            this->parts.resize(used_part_count);
+            this->last_part = used_part_count - 1;
+
+            polyapprox_helpers::fit_hermite<Calculable>(src, polyapprox_helpers::uniform_nodes<Calculable>(used_part_count, range_min, range_max, inc), dx,
+                [this, inc](unsigned i, Calculable, const std::array<Calculable, 4>& coeffs) {
+                    // coefficients of t / width
+                    const std::array<double, 3> scaled{{(double)(coeffs[1] * inc), (double)(coeffs[2] * inc * inc), (double)(coeffs[3] * inc * inc * inc)}};
+                    part& p = this->parts[i];
+                    p.c0 = Fixed(coeffs[0]).getBuf();
+                    p.exponent = coefficient_exponent(scaled);
+                    for (unsigned j=0;j<3;j++)
+                        p.c[j] = saturate(std::ldexp(scaled[j], p.exponent));
+                });
+        }
+
+};
+
+
+// Integer evaluation of fixed point approximations - Horner in Horner (CALCULATE_TYPE of Fixed by default, f.e. raw_type where it is wide enough)
+// instead of fixed point multiplications with their conversions. Parts have a width of a power of two, the argument is aligned (multiplied by a power
+// of two) to a variable of the part with variable_bits (half of Horner) fraction bits, so the index and the shifts of the Horner steps are constants.
+// c1..c3 are stored in Horner (the loads fold into the arithmetic) with one exponent for the table - the largest part decides the error anyway.
+// Without a wider CALCULATE_TYPE (f.e. fixed32_s, fixed64) the parts are at most 2^(variable_bits - fraction_bits) wide and more parts may be used.
+// Arguments outside the range are clamped to it.
+template <typename Fixed, typename Horner = typename std::make_signed<typename Fixed::CALCULATE_TYPE>::type>
+class IntPolyApprox {
+
+    static_assert(polyapprox_helpers::has_raw_buffer<Fixed>::value, "IntPolyApprox works with fixed point types");
+    static_assert(std::is_integral<Horner>::value && std::is_signed<Horner>::value && sizeof(Horner) >= 4, "Horner must be a signed integer of at least 32 bits");
+
+    public:
+
+        using raw_type = decltype(std::declval<Fixed>().getBuf());
+
+        // c1..c3 scaled by 2^(shift - variable_bits + fraction_bits), value at the beginning (rounded up by half of the last place - the last shift rounds down)
+        struct part {
+            Horner c[3];
+            raw_type c0;
+        };
+
+        IntPolyApprox() = default;
+        IntPolyApprox(const IntPolyApprox&) = default;
+        IntPolyApprox(IntPolyApprox&&) = default;
+
+
+        template <typename Calculable>
+        IntPolyApprox(const std::function<Calculable(Calculable)>& src, unsigned part_count, Calculable range_min, Calculable range_max, Calculable dx=1e-3) {
+            __fit<Calculable>(src, part_count, range_min, range_max, dx);
+        }
+
+
+        template <typename Calculable>
+        static IntPolyApprox create(const std::function<Calculable(Calculable)>& src, unsigned part_count, Calculable range_min, Calculable range_max, Calculable dx=1e-3) {
+            return IntPolyApprox(src, part_count, range_min, range_max, dx);
+        }
+
+
+        template <typename Calculable>
+        void fit(const std::function<Calculable(Calculable)>& src, unsigned part_count, Calculable range_min, Calculable range_max, Calculable dx=1e-3) {
+            __fit<Calculable>(src, part_count, range_min, range_max, dx);
+        }
+
+
+        Fixed call(Fixed x) const noexcept {
+            raw_type raw = x.getBuf();
+            raw = (raw < range_min) ? range_min : raw;
+            raw = (raw > range_max) ? range_max : raw;
+            const index_type position = (index_type)((unsigned_raw_type)raw - (unsigned_raw_type)range_min) * scale;
+            const part& p = parts[position >> variable_bits];
+            const Horner t = position & variable_mask;
+            Horner acc = p.c[2];
+            acc = ((acc * t) >> variable_bits) + p.c[1];
+            acc = ((acc * t) >> variable_bits) + p.c[0];
+            return Fixed::buf_cast((raw_type)(p.c0 + ((acc * t) >> shift)));
+        }
+
+
+        Fixed operator()(Fixed x) const noexcept {
+            return call(x);
+        }
+
+
+        // width of a part is 2^getWidthLog2()
+        int getWidthLog2() const noexcept {
+            int scale_log2 = 0;
+            while (((index_type)1 << scale_log2) < scale)
+                scale_log2++;
+            return (int)variable_bits - scale_log2 - (int)Fixed::fraction_bits;
+        }
+
+
+        // the last Horner step shifts by getShift(), the coefficients are scaled by 2^(getShift() - variable_bits + fraction_bits)
+        unsigned getShift() const noexcept {
+            return shift;
+        }
+
+
+        unsigned getPartCount() const noexcept {
+            return parts.empty() ? 0 : parts.size() - 1;
+        }
+
+
+        const part& getPart(unsigned i) const noexcept {
+            return parts[i];
+        }
+
+
+        // memory used by the coefficients
+        std::size_t getTableBytes() const noexcept {
+            return parts.size() * sizeof(part);
+        }
+
+
+        template <typename Calculable>
+        Calculable getMaxError(const std::function<Calculable(Calculable)>& fun, Calculable dx=1e-6) const {
+            Calculable x = Fixed::buf_cast(range_min);
+            Calculable max_x = Fixed::buf_cast(range_max);
+            Calculable result = 0;
+            while (x <= max_x) {
+                Calculable diff = polyapprox_helpers::abs<Calculable>(Calculable(call(x)) - fun(x));
+                if (diff > result)
+                    result = diff;
+                x += dx;
+            }
+            return result;
+        }
+
+
+        IntPolyApprox& operator=(const IntPolyApprox&) = default;
+        IntPolyApprox& operator=(IntPolyApprox&&) = default;
+
+
+    private:
+
+        using unsigned_raw_type = typename std::make_unsigned<raw_type>::type;
+        using index_type = typename std::make_unsigned<Horner>::type;
+
+        // |acc| <= |c1| + |c2| + |c3| < 2^(variable_bits - 1) and t < 2^variable_bits, so acc * t fits in Horner
+        constexpr static const unsigned variable_bits = 4 * sizeof(Horner);
+        constexpr static const index_type variable_mask = ((index_type)1 << variable_bits) - 1;
+        // with Horner twice as wide as the buffer the coefficients of any part of the range hold the fraction bits
+        constexpr static const bool wide_horner = sizeof(Horner) >= 2 * sizeof(raw_type);
+        constexpr static const int max_width_log2 = wide_horner ? 8 * (int)sizeof(raw_type) : (int)variable_bits - (int)Fixed::fraction_bits;
+        // the value has fraction_bits after the last shift
+        constexpr static const int min_shift = wide_horner ? (int)variable_bits : 1;
+        constexpr static const int max_shift = 8 * (int)sizeof(Horner) - 1;
+
+        std::vector<part> parts;
+        raw_type range_min = 0;
+        raw_type range_max = 0;
+        index_type scale = 1;
+        unsigned shift = max_shift;
+
+
+        // the largest shift with the sum of the coefficients below 2^(variable_bits - 1)
+        static int coefficient_shift(double sum) {
+            const double limit = std::ldexp(1.0, variable_bits - 1) - 1;
+            int shift = max_shift;
+            while (shift > min_shift && std::round(sum * std::ldexp(1.0, shift - (int)variable_bits + (int)Fixed::fraction_bits)) > limit)
+                shift--;
+            return shift;
+        }
+
+
+        template<typename T>
+        static T saturate(double value) {
+            const double rounded = std::round(value);
+            if (rounded > std::numeric_limits<T>::max()) return std::numeric_limits<T>::max();
+            if (rounded < std::numeric_limits<T>::min()) return std::numeric_limits<T>::min();
+            return (T)rounded;
+        }
+
+
+        // the last shift rounds down, so the value at the beginning is rounded up by half of the last place
+        static raw_type start_value(double value) {
+            return saturate<raw_type>(std::floor(std::ldexp(value, Fixed::fraction_bits) + 1));
+        }
+
+
+        template <typename Calculable>
+        void __fit(const std::function<Calculable(Calculable)>& src, unsigned max_part_count, Calculable range_min, Calculable range_max, Calculable dx=1e-3) {
+            // the smallest power of two which covers the range with max_part_count parts (limited by the alignment of the variable)
+            const Calculable range = range_max - range_min;
+            Calculable inc = 1;
+            int inc_log2 = 0;
+            while (inc * max_part_count < range && inc_log2 < max_width_log2) {
+                inc *= 2;
+                inc_log2++;
+            }
+            while (inc_log2 > max_width_log2 || (inc_log2 > -(int)Fixed::fraction_bits && (inc / 2) * max_part_count >= range)) {
+                inc /= 2;
+                inc_log2--;
+            }
+            unsigned used_part_count = 1;
+            while (used_part_count * inc < range)
+                used_part_count++;
+
+            this->range_min = Fixed(range_min).getBuf();
+            this->range_max = Fixed(range_max).getBuf();
+            this->scale = (index_type)1 << (variable_bits - (Fixed::fraction_bits + inc_log2));
+            // the end of the range is the beginning of the part after the last one
+            this->parts.assign(used_part_count + 1, part{{0, 0, 0}, start_value(src(range_max))});
+
+            // coefficients of t / width, scaled when the shift of the table is known
+            std::vector<std::array<double, 3>> scaled(used_part_count);
+            double largest_sum = 0;
+            polyapprox_helpers::fit_hermite<Calculable>(src, polyapprox_helpers::uniform_nodes<Calculable>(used_part_count, range_min, range_max, inc), dx,
+                [this, inc, &scaled, &largest_sum](unsigned i, Calculable, const std::array<Calculable, 4>& coeffs) {
+                    scaled[i] = {{(double)(coeffs[1] * inc), (double)(coeffs[2] * inc * inc), (double)(coeffs[3] * inc * inc * inc)}};
+                    largest_sum = polyapprox_helpers::max<double>(largest_sum, polyapprox_helpers::abs<double>(scaled[i][0])
+                        + polyapprox_helpers::abs<double>(scaled[i][1]) + polyapprox_helpers::abs<double>(scaled[i][2]));
+                    this->parts[i].c0 = start_value(coeffs[0]);
+                });
+            this->shift = coefficient_shift(largest_sum);
+            for (unsigned i=0;i<used_part_count;i++)
+                for (unsigned j=0;j<3;j++)
+                    this->parts[i].c[j] = saturate<Horner>(std::ldexp(scaled[i][j], (int)shift - (int)variable_bits + (int)Fixed::fraction_bits));
+        }
+
+};
+
+#endif
@@ -0,0 +1,209 @@
+/****************************************************************************************
+
+                                       MIT License
+
+               Copyright (c) 2025 Pawel Bielecki [pbielecki2000@gmail.com]
+
+       Permission is hereby granted, free of charge, to any person obtaining a copy
+      of this software and associated documentation files (the "Software"), to deal
+       in the Software without restriction, including without limitation the rights
+        to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+          copies of the Software, and to permit persons to whom the Software is
+                 furnished to do so, subject to the following conditions:
+
+      The above copyright notice and this permission notice shall be included in all
+                     copies or substantial portions of the Software.
+
+        THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+         IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+       FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+          AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+      LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+      OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+                                        SOFTWARE.
+
+****************************************************************************************/
+
+#ifndef POLY_APPROX_FOLD
+#define POLY_APPROX_FOLD
+
+#include <cmath>
+#include <cstdint>
+#include <functional>
+#include <type_traits>
+
+#include "polyapprox.h"
+
+
+enum class PolyApproxParity {
+    none,
+    even,   // f(-x) = f(x)
+    odd     // f(-x) = -f(x)
+};
+
+
+// Symmetries of the source function - the argument is folded in this order:
+//   period         - x is moved to [-period/2, period/2)
+//   parity         - negative x is mirrored (about 0)
+//   reflect_at     - x above it is mirrored about it, f(2 * reflect_at - x) = f(x) (even) or -f(x) (odd)
+struct PolyApproxFold {
+    double period = 0;
+    PolyApproxParity parity = PolyApproxParity::none;
+    double reflect_at = 0;
+    PolyApproxParity reflect_parity = PolyApproxParity::none;
+
+    // sin-like functions need only the first quarter of the period
+    static PolyApproxFold sine(double period) {
+        PolyApproxFold fold;
+        fold.period = period;
+        fold.parity = PolyApproxParity::odd;
+        fold.reflect_at = period / 4;
+        fold.reflect_parity = PolyApproxParity::even;
+        return fold;
+    }
+
+    static PolyApproxFold cosine(double period) {
+        PolyApproxFold fold;
+        fold.period = period;
+        fold.parity = PolyApproxParity::even;
+        fold.reflect_at = period / 4;
+        fold.reflect_parity = PolyApproxParity::odd;
+        return fold;
+    }
+};
+
+
+// Approximation fitted only on the part of the range left after folding (f.e. a quarter of the period of sin),
+// so the table covers all arguments. For fixed point types a period of a power of two of raw units is folded with a mask.
+// Approx is PolyApprox or ShiftPolyApprox of Storable.
+template <typename Storable, typename Approx = PolyApprox<Storable>>
+class FoldedPolyApprox {
+
+    public:
+
+        FoldedPolyApprox() = default;
+        FoldedPolyApprox(const FoldedPolyApprox&) = default;
+        FoldedPolyApprox(FoldedPolyApprox&&) = default;
+
+
+        // range_min and range_max are used only without a period (range_min also only without parity)
+        template <typename Calculable>
+        FoldedPolyApprox(const std::function<Calculable(Calculable)>& src, unsigned part_count, const PolyApproxFold& fold,
+                         Calculable range_min=0, Calculable range_max=0, Calculable dx=1e-3, PolyApproxFit mode=PolyApproxFit::hermite) {
+            __fit<Calculable>(src, part_count, fold, range_min, range_max, dx, mode);
+        }
+
+
+        template <typename Calculable>
+        static FoldedPolyApprox create(const std::function<Calculable(Calculable)>& src, unsigned part_count, const PolyApproxFold& fold,
+                                       Calculable range_min=0, Calculable range_max=0, Calculable dx=1e-3, PolyApproxFit mode=PolyApproxFit::hermite) {
+            return FoldedPolyApprox(src, part_count, fold, range_min, range_max, dx, mode);
+        }
+
+
+        Storable call(Storable x) const noexcept {
+            bool negate = false;
+            if (periodic)
+                x = wrap<Storable>(x);
+            if (parity != PolyApproxParity::none && x < Storable(0)) {
+                x = -x;
+                negate = parity == PolyApproxParity::odd;
+            }
+            if (reflect && x > reflect_at) {
+                x = twice_reflect_at - x;
+                negate ^= reflect_parity == PolyApproxParity::odd;
+            }
+            Storable y = approx(x);
+            return negate ? -y : y;
+        }
+
+
+        Storable operator()(Storable x) const noexcept {
+            return call(x);
+        }
+
+
+        // the fitted approximation (on the folded range)
+        const Approx& getApprox() const noexcept {
+            return approx;
+        }
+
+
+        // the period is folded with a mask of the raw buffer
+        bool isMaskFolded() const noexcept {
+            return mask;
+        }
+
+
+        FoldedPolyApprox& operator=(const FoldedPolyApprox&) = default;
+        FoldedPolyApprox& operator=(FoldedPolyApprox&&) = default;
+
+
+    private:
+
+        Approx approx;
+        bool periodic = false;
+        bool mask = false;
+        bool reflect = false;
+        PolyApproxParity parity = PolyApproxParity::none;
+        PolyApproxParity reflect_parity = PolyApproxParity::none;
+        Storable period = 0;
+        Storable inv_period = 0;
+        Storable reflect_at = 0;
+        Storable twice_reflect_at = 0;
+        std::int64_t period_raw = 0;
+
+
+        template<typename T, typename std::enable_if<polyapprox_helpers::has_raw_buffer<T>::value, void>::type* = nullptr>
+        T wrap(T x) const noexcept {
+            std::int64_t raw = x.getBuf();
+            raw = mask ? (raw & (period_raw - 1)) : (raw % period_raw);
+            raw += (raw < 0) ? period_raw : 0;
+            raw -= (2 * raw >= period_raw) ? period_raw : 0;
+            return T::buf_cast(raw);
+        }
+
+
+        template<typename T, typename std::enable_if<!polyapprox_helpers::has_raw_buffer<T>::value, void>::type* = nullptr>
+        T wrap(T x) const noexcept {
+            return x - period * std::floor(x * inv_period + T(0.5));
+        }
+
+
+        template<typename T>
+        static typename std::enable_if<polyapprox_helpers::has_raw_buffer<T>::value, std::int64_t>::type raw_of(T x) {
+            return x.getBuf();
+        }
+
+
+        template<typename T>
+        static typename std::enable_if<!polyapprox_helpers::has_raw_buffer<T>::value, std::int64_t>::type raw_of(T) {
+            return 0;
+        }
+
+
+        template <typename Calculable>
+        void __fit(const std::function<Calculable(Calculable)>& src, unsigned part_count, const PolyApproxFold& fold,
+                   Calculable range_min, Calculable range_max, Calculable dx, PolyApproxFit mode) {
+            periodic = fold.period > 0;
+            parity = fold.parity;
+            reflect = fold.reflect_at > 0;
+            reflect_parity = fold.reflect_parity;
+            period = Storable(fold.period);
+            inv_period = periodic ? Storable(1 / fold.period) : Storable(0);
+            reflect_at = Storable(fold.reflect_at);
+            twice_reflect_at = Storable(2 * fold.reflect_at);
+            period_raw = raw_of<Storable>(period);
+            mask = periodic && polyapprox_helpers::has_raw_buffer<Storable>::value && period_raw > 0 && (period_raw & (period_raw - 1)) == 0;
+
+            // the range left after folding
+            Calculable low = periodic ? Calculable(-fold.period / 2) : range_min;
+            Calculable high = periodic ? Calculable(fold.period / 2) : range_max;
+            if (parity != PolyApproxParity::none) low = 0;
+            if (reflect) high = Calculable(fold.reflect_at);
+            approx = Approx::template create<Calculable>(src, part_count, low, high, dx, mode);
+        }
+
+};
+
+#endif
@@ -0,0 +1,369 @@
+/****************************************************************************************
+
+                                       MIT License
+
+               Copyright (c) 2025 Pawel Bielecki [pbielecki2000@gmail.com]
+
+       Permission is hereby granted, free of charge, to any person obtaining a copy
+      of this software and associated documentation files (the "Software"), to deal
+       in the Software without restriction, including without limitation the rights
+        to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+          copies of the Software, and to permit persons to whom the Software is
+                 furnished to do so, subject to the following conditions:
+
+      The above copyright notice and this permission notice shall be included in all
+                     copies or substantial portions of the Software.
+
+        THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+         IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+       FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+          AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+      LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+      OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+                                        SOFTWARE.
+
+****************************************************************************************/
+
+#ifndef POLY_APPROX_IO
+#define POLY_APPROX_IO
+
+#include <istream>
+#include <ostream>
+#include <fstream>
+#include <cstring>
+#include <cstdint>
+#include <cstddef>
+#include <array>
+#include <vector>
+#include <type_traits>
+#include <utility>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#define POLYAPPROX_MMAP 1
+#endif
+
+#include "polyapprox.h"
+
+
+// Binary files with fitted PolyApprox tables - the file is written once and loaded (or mapped) instead of fitting at start.
+// Layout (native byte order, checked on load):
+//   64 byte header: "PAPX", version, byte order mark, storable type id, part count, range_min, inv_incrementator
+//   part count * {c0, c1, c2, c3, x0} - the same layout as the coefficients in memory, so a mapped file is used in place
+namespace polyapprox_io {
+
+    constexpr const std::uint16_t format_version = 1;
+    constexpr const std::uint16_t byte_order_mark = 0x0102;
+    constexpr const std::size_t header_size = 64;
+
+
+    struct file_header {
+        char magic[4];
+        std::uint16_t version;
+        std::uint16_t byte_order;
+        std::uint32_t type_id;
+        std::uint32_t part_count;
+        unsigned char range_min[16];
+        unsigned char inv_incrementator[16];
+        unsigned char reserved[16];
+    };
+
+    static_assert(sizeof(file_header) == header_size, "file header must have 64 bytes");
+
+
+    // kind (1 - floating point, 2 - signed fixed point, 3 - unsigned fixed point), size and fraction bits of the storable type
+    // fixed point types with the same buffer and fraction bits share the id (f.e. fixed32, fixed32_a and fixed32_s)
+    template<typename T, typename std::enable_if<polyapprox_helpers::has_raw_buffer<T>::value, void>::type* = nullptr>
+    constexpr std::uint32_t type_id() {
+        return ((std::is_signed<decltype(std::declval<T>().getBuf())>::value ? 2u : 3u) << 16) | (sizeof(T) << 8) | T::fraction_bits;
+    }
+
+
+    template<typename T, typename std::enable_if<!polyapprox_helpers::has_raw_buffer<T>::value, void>::type* = nullptr>
+    constexpr std::uint32_t type_id() {
+        return (1u << 16) | (sizeof(T) << 8);
+    }
+
+
+    template<typename Storable>
+    file_header make_header(unsigned part_count, Storable range_min, Storable inv_incrementator) {
+        static_assert(sizeof(Storable) <= 16, "storable type must have at most 16 bytes");
+        static_assert(std::is_trivially_copyable<Storable>::value, "storable type must be trivially copyable");
+        file_header header;
+        std::memset(&header, 0, sizeof(header));
+        std::memcpy(header.magic, "PAPX", 4);
+        header.version = format_version;
+        header.byte_order = byte_order_mark;
+        header.type_id = type_id<Storable>();
+        header.part_count = part_count;
+        std::memcpy(header.range_min, &range_min, sizeof(Storable));
+        std::memcpy(header.inv_incrementator, &inv_incrementator, sizeof(Storable));
+        return header;
+    }
+
+
+    template<typename Storable>
+    bool check_header(const file_header& header) {
+        return std::memcmp(header.magic, "PAPX", 4) == 0 && header.version == format_version && header.byte_order == byte_order_mark
+            && header.type_id == type_id<Storable>() && header.part_count > 0;
+    }
+
+
+    template<typename Storable>
+    Storable header_value(const unsigned char* bytes) {
+        Storable value;
+        std::memcpy(&value, bytes, sizeof(Storable));
+        return value;
+    }
+
+
+    // nothing is written for an approximation without parts - load rejects such a table
+    template<typename Storable, unsigned static_part_count>
+    bool save(std::ostream& out, const PolyApprox<Storable, static_part_count>& approx) {
+        const unsigned part_count = approx.getPartCount();
+        if (part_count == 0)
+            return false;
+        const file_header header = make_header<Storable>(part_count, approx.getRangeMin(), approx.getInvIncrementator());
+        out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        out.write(reinterpret_cast<const char*>(&approx.getCoefficients(0)), sizeof(std::array<Storable, 5>) * part_count);
+        return bool(out);
+    }
+
+
+    template<typename Storable, unsigned static_part_count>
+    bool save(const char* path, const PolyApprox<Storable, static_part_count>& approx) {
+        std::ofstream out(path, std::ios::binary);
+        return save(out, approx) && bool(out.flush());
+    }
+
+
+    template<typename Coefficients>
+    bool resize(Coefficients& coefficients, unsigned part_count) {
+        return coefficients.size() == part_count;
+    }
+
+
+    template<typename Storable>
+    bool resize(std::vector<std::array<Storable, 5>>& coefficients, unsigned part_count) {
+        coefficients.resize(part_count);
+        return true;
+    }
+
+
+    // approx is left unchanged if the stream does not contain a table of Storable (and of static_part_count parts for the static version)
+    template<typename Storable, unsigned static_part_count>
+    bool load(std::istream& in, PolyApprox<Storable, static_part_count>& approx) {
+        using approx_type = PolyApprox<Storable, static_part_count>;
+        file_header header;
+        if (!in.read(reinterpret_cast<char*>(&header), sizeof(header)) || !check_header<Storable>(header))
+            return false;
+        typename approx_type::coefficients_type coefficients;
+        if (!resize(coefficients, header.part_count))
+            return false;
+        if (!in.read(reinterpret_cast<char*>(coefficients.data()), sizeof(std::array<Storable, 5>) * header.part_count))
+            return false;
+        approx = approx_type(coefficients, header_value<Storable>(header.range_min), header_value<Storable>(header.inv_incrementator));
+        return true;
+    }
+
+
+    template<typename Storable, unsigned static_part_count>
+    bool load(const char* path, PolyApprox<Storable, static_part_count>& approx) {
+        std::ifstream in(path, std::ios::binary);
+        return load(in, approx);
+    }
+
+}
+
+
+// Non-owning approximation - evaluates a table owned by a PolyApprox, a constexpr table or a mapped file.
+// The table must outlive the view.
+template <typename Storable>
+class PolyApproxView {
+
+    public:
+
+        PolyApproxView() = default;
+
+        PolyApproxView(const std::array<Storable, 5>* coefficients, unsigned part_count, Storable range_min, Storable inv_incrementator) noexcept
+            : coefficients(coefficients), part_count(part_count), range_min(range_min), inv_incrementator(inv_incrementator) {}
+
+        template <unsigned static_part_count>
+        PolyApproxView(const PolyApprox<Storable, static_part_count>& approx) noexcept
+            : PolyApproxView(approx.getPartCount() ? &approx.getCoefficients(0) : nullptr, approx.getPartCount(), approx.getRangeMin(), approx.getInvIncrementator()) {}
+
+
+        // view of a serialized table in memory - empty if data does not hold a table of Storable
+        static PolyApproxView fromBytes(const void* data, std::size_t size) noexcept {
+            const polyapprox_io::file_header* header = static_cast<const polyapprox_io::file_header*>(data);
+            if (size < sizeof(*header) || !polyapprox_io::check_header<Storable>(*header))
+                return PolyApproxView();
+            if ((size - sizeof(*header)) / sizeof(std::array<Storable, 5>) < header->part_count)
+                return PolyApproxView();
+            return PolyApproxView(reinterpret_cast<const std::array<Storable, 5>*>(static_cast<const char*>(data) + sizeof(*header)), header->part_count,
+                polyapprox_io::header_value<Storable>(header->range_min), polyapprox_io::header_value<Storable>(header->inv_incrementator));
+        }
+
+
+        Storable call(Storable x) const noexcept {
+            const auto& coeff = coefficients[part_index(x)];
+            x -= coeff[4];
+            return ((coeff[3] * x + coeff[2]) * x + coeff[1]) * x + coeff[0];
+        }
+
+
+        Storable operator()(Storable x) const noexcept {
+            return call(x);
+        }
+
+
+        bool empty() const noexcept {
+            return part_count == 0;
+        }
+
+
+        unsigned getPartCount() const noexcept {
+            return part_count;
+        }
+
+
+        const std::array<Storable, 5>& getCoefficients(unsigned part) const noexcept {
+            return coefficients[part];
+        }
+
+
+        Storable getRangeMin() const noexcept {
+            return range_min;
+        }
+
+
+        Storable getInvIncrementator() const noexcept {
+            return inv_incrementator;
+        }
+
+
+    private:
+
+        const std::array<Storable, 5>* coefficients = nullptr;
+        unsigned part_count = 0;
+        Storable range_min = 0;
+        Storable inv_incrementator = 0;
+
+
+        unsigned part_index(Storable x) const noexcept {
+            unsigned part = std::floor((x - range_min) * inv_incrementator);
+            return (part < part_count) ? part : part_count-1;
+        }
+
+};
+
+
+#ifdef POLYAPPROX_MMAP
+
+// Read-only mapping of a file written by polyapprox_io::save - the pages are loaded on the first access
+// and shared between all processes mapping the same file.
+template <typename Storable>
+class MappedPolyApprox {
+
+    public:
+
+        MappedPolyApprox() = default;
+
+        explicit MappedPolyApprox(const char* path) {
+            open(path);
+        }
+
+        MappedPolyApprox(const MappedPolyApprox&) = delete;
+        MappedPolyApprox& operator=(const MappedPolyApprox&) = delete;
+
+        MappedPolyApprox(MappedPolyApprox&& another) noexcept
+            : address(another.address), size(another.size), view(another.view) {
+            another.address = nullptr;
+            another.size = 0;
+            another.view = PolyApproxView<Storable>();
+        }
+
+        MappedPolyApprox& operator=(MappedPolyApprox&& another) noexcept {
+            if (this != &another) {
+                close();
+                std::swap(address, another.address);
+                std::swap(size, another.size);
+                std::swap(view, another.view);
+            }
+            return *this;
+        }
+
+        ~MappedPolyApprox() {
+            close();
+        }
+
+
+        // false if the file cannot be mapped or does not hold a table of Storable
+        bool open(const char* path) {
+            close();
+            int fd = ::open(path, O_RDONLY);
+            if (fd < 0)
+                return false;
+            struct stat info;
+            if (fstat(fd, &info) != 0 || info.st_size < (off_t)polyapprox_io::header_size) {
+                ::close(fd);
+                return false;
+            }
+            void* mapped = mmap(nullptr, info.st_size, PROT_READ, MAP_SHARED, fd, 0);
+            ::close(fd);
+            if (mapped == MAP_FAILED)
+                return false;
+            address = mapped;
+            size = info.st_size;
+            view = PolyApproxView<Storable>::fromBytes(address, size);
+            if (view.empty()) {
+                close();
+                return false;
+            }
+            return true;
+        }
+
+
+        void close() noexcept {
+            if (address)
+                munmap(address, size);
+            address = nullptr;
+            size = 0;
+            view = PolyApproxView<Storable>();
+        }
+
+
+        Storable call(Storable x) const noexcept {
+            return view.call(x);
+        }
+
+
+        Storable operator()(Storable x) const noexcept {
+            return view.call(x);
+        }
+
+
+        bool isOpen() const noexcept {
+            return address != nullptr;
+        }
+
+
+        const PolyApproxView<Storable>& getView() const noexcept {
+            return view;
+        }
+
+
+    private:
+
+        void* address = nullptr;
+        std::size_t size = 0;
+        PolyApproxView<Storable> view;
+
+};
+
+#endif
+
+#endif
@@ -0,0 +1,187 @@
+/****************************************************************************************
+
+                                       MIT License
+
+               Copyright (c) 2025 Pawel Bielecki [pbielecki2000@gmail.com]
+
+       Permission is hereby granted, free of charge, to any person obtaining a copy
+      of this software and associated documentation files (the "Software"), to deal
+       in the Software without restriction, including without limitation the rights
+        to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+          copies of the Software, and to permit persons to whom the Software is
+                 furnished to do so, subject to the following conditions:
+
+      The above copyright notice and this permission notice shall be included in all
+                     copies or substantial portions of the Software.
+
+        THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+         IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+       FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+          AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+      LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+      OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+                                        SOFTWARE.
+
+****************************************************************************************/
+
+
+#ifndef POLY_APPROX_PARALLEL
+#define POLY_APPROX_PARALLEL
+
+#include <thread>
+#include <cmath>
+#include <vector>
+#include <array>
+#include <cstdint>
+#include <cstddef>
+#include <functional>
+#include <type_traits>
+
+#include "polyapprox.h"
+
+
+// Fitting and verification of approximations on many threads - for generators and tests, not for firmware.
+namespace polyapprox_parallel {
+
+    inline unsigned default_thread_count() {
+        unsigned threads = std::thread::hardware_concurrency();
+        return threads ? threads : 1;
+    }
+
+
+    // calls fun(thread, begin, end) for consecutive chunks of [0, count)
+    template<typename Fun>
+    void for_chunks(std::size_t count, unsigned threads, Fun fun) {
+        threads = (threads < count) ? threads : (unsigned)count;
+        if (threads <= 1) {
+            fun(0, 0, count);
+            return;
+        }
+        std::vector<std::thread> workers;
+        for (unsigned t=0;t<threads;t++) {
+            std::size_t begin = count * t / threads;
+            std::size_t end = count * (t + 1) / threads;
+            workers.emplace_back([&fun, t, begin, end]() {fun(t, begin, end);});
+        }
+        for (auto& worker: workers)
+            worker.join();
+    }
+
+
+    // the same parts as polyapprox_helpers::fit_hermite - values and derivatives of the nodes first, then the parts
+    // src is called concurrently, store(i, x0, coefficients) is called concurrently for different parts
+    template <typename Calculable, typename Store>
+    void fit_hermite(const std::function<Calculable(Calculable)>& src, const std::vector<Calculable>& nodes, Calculable dx, Store store,
+                     unsigned threads=default_thread_count()) {
+        const std::size_t part_count = nodes.size() - 1;
+        const Calculable inv_dx = Calculable(1) / dx;
+        const Calculable half_inv_dx = inv_dx / 2;
+        std::vector<Calculable> values(nodes.size());
+        std::vector<Calculable> deriverates(nodes.size());
+        for_chunks(nodes.size(), threads, [&](unsigned, std::size_t begin, std::size_t end) {
+            for (std::size_t i=begin;i<end;i++) {
+                Calculable x = nodes[i];
+                values[i] = src(x);
+                if (i == 0) deriverates[i] = (src(x+dx) - values[i]) * inv_dx;
+                else if (i < part_count) deriverates[i] = (src(x+dx) - src(x-dx)) * half_inv_dx;
+                else deriverates[i] = (values[i] - src(x-dx)) * inv_dx;
+            }
+        });
+        for_chunks(part_count, threads, [&](unsigned, std::size_t begin, std::size_t end) {
+            for (std::size_t i=begin;i<end;i++)
+                store(i, nodes[i], polyapprox_helpers::hermite_part<Calculable>(src, nodes[i], nodes[i+1] - nodes[i], values[i], deriverates[i], values[i+1], deriverates[i+1]));
+        });
+    }
+
+
+    template<typename CT>
+    typename std::enable_if<std::is_same<CT, std::vector<typename CT::value_type>>::value, void>::type resize(CT& coefficients, unsigned size) {
+        coefficients.resize(size);
+    }
+
+
+    template<typename CT>
+    typename std::enable_if<!std::is_same<CT, std::vector<typename CT::value_type>>::value, void>::type resize(CT&, unsigned) {}
+
+
+    // the same result as PolyApprox<Storable, static_part_count>::create, part_count is ignored for the static version
+    template <typename Storable, unsigned static_part_count, typename Calculable>
+    PolyApprox<Storable, static_part_count> create(const std::function<Calculable(Calculable)>& src, unsigned part_count, Calculable range_min, Calculable range_max,
+                                                   Calculable dx=1e-3, unsigned threads=default_thread_count()) {
+        using Approx = PolyApprox<Storable, static_part_count>;
+        if (Approx::is_static) part_count = static_part_count;
+        typename Approx::coefficients_type coefficients;
+        resize(coefficients, part_count);
+        Calculable inc = (range_max - range_min) / part_count;
+        fit_hermite<Calculable>(src, polyapprox_helpers::uniform_nodes<Calculable>(part_count, range_min, range_max, inc), dx,
+            [&coefficients](std::size_t i, Calculable x0, const std::array<Calculable, 4>& part) {
+                auto& coeffs = coefficients[i];
+                coeffs[4] = x0;
+                for (unsigned j=0;j<4;j++)
+                    coeffs[j] = part[j];
+            }, threads);
+        return Approx(coefficients, range_min, Calculable(1) / inc);
+    }
+
+
+    struct error_report {
+        std::uint64_t count = 0;
+        double max_error = 0;
+        double max_error_x = 0;
+        double mean_error = 0;
+        // ulp_histogram[i] - number of results with the error of i units of the last place, the last bin counts all larger errors
+        std::vector<std::uint64_t> ulp_histogram;
+    };
+
+
+    // every representable argument of the fixed point type in [range_min, range_max] is checked against the reference
+    template<typename Fixed, typename Approx, typename std::enable_if<polyapprox_helpers::has_raw_buffer<Fixed>::value, void>::type* = nullptr>
+    error_report verify(const Approx& approx, const std::function<double(double)>& reference, Fixed range_min, Fixed range_max,
+                        unsigned histogram_size=16, unsigned threads=default_thread_count()) {
+        const std::int64_t first = range_min.getBuf();
+        const std::int64_t count = (std::int64_t)range_max.getBuf() - first + 1;
+        const double ulp = (double)Fixed::buf_cast(1);
+        std::vector<error_report> partial(threads ? threads : 1);
+        std::vector<double> sums(partial.size(), 0);
+        for_chunks(count > 0 ? count : 0, threads, [&](unsigned t, std::size_t begin, std::size_t end) {
+            error_report& report = partial[t];
+            report.ulp_histogram.assign(histogram_size, 0);
+            double sum = 0;
+            for (std::size_t i=begin;i<end;i++) {
+                const Fixed x = Fixed::buf_cast(first + (std::int64_t)i);
+                const double error = std::abs((double)approx(x) - reference((double)x));
+                const double ulps = error / ulp + 0.5;
+                const std::size_t bin = (ulps < histogram_size - 1) ? (std::size_t)ulps : histogram_size - 1;
+                report.ulp_histogram[bin]++;
+                sum += error;
+                if (error > report.max_error) {
+                    report.max_error = error;
+                    report.max_error_x = (double)x;
+                }
+            }
+            report.count = end - begin;
+            sums[t] = sum;
+        });
+
+        error_report result;
+        result.ulp_histogram.assign(histogram_size, 0);
+        double sum = 0;
+        for (std::size_t t=0;t<partial.size();t++) {
+            const error_report& report = partial[t];
+            if (!report.count) continue;
+            result.count += report.count;
+            sum += sums[t];
+            if (report.max_error > result.max_error) {
+                result.max_error = report.max_error;
+                result.max_error_x = report.max_error_x;
+            }
+            for (unsigned i=0;i<histogram_size;i++)
+                result.ulp_histogram[i] += report.ulp_histogram[i];
+        }
+        result.mean_error = result.count ? sum / result.count : 0;
+        return result;
+    }
+
+}
+
+#endif
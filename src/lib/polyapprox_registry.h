@@ -0,0 +1,148 @@
+/****************************************************************************************
+
+                                       MIT License
+
+               Copyright (c) 2025 Pawel Bielecki [pbielecki2000@gmail.com]
+
+       Permission is hereby granted, free of charge, to any person obtaining a copy
+      of this software and associated documentation files (the "Software"), to deal
+       in the Software without restriction, including without limitation the rights
+        to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+          copies of the Software, and to permit persons to whom the Software is
+                 furnished to do so, subject to the following conditions:
+
+      The above copyright notice and this permission notice shall be included in all
+                     copies or substantial portions of the Software.
+
+        THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+         IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+       FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+          AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+      LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+      OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+                                        SOFTWARE.
+
+****************************************************************************************/
+
+#ifndef POLY_APPROX_REGISTRY
+#define POLY_APPROX_REGISTRY
+
+#include <map>
+#include <tuple>
+#include <mutex>
+#include <atomic>
+#include <memory>
+#include <string>
+#include <vector>
+#include <functional>
+
+#include "polyapprox.h"
+#include "polyapprox_parallel.h"
+
+
+// Process-wide cache of fitted tables - modules asking for the same function, range, part count and dx share one read-only PolyApprox.
+// The function is identified by its name (std::function has no identity), the storable type by the registry instance.
+// Until seal() tables are fitted on the first request (lookups take a mutex, fitting does not),
+// after seal() the map is never modified and lookups do not lock.
+template <typename Storable, typename Calculable = double>
+class PolyApproxRegistry {
+
+    public:
+
+        using approx_type = PolyApprox<Storable>;
+        using pointer = std::shared_ptr<const approx_type>;
+
+        struct request {
+            std::string name;
+            std::function<Calculable(Calculable)> src;
+            unsigned part_count;
+            Calculable range_min;
+            Calculable range_max;
+            Calculable dx;
+        };
+
+
+        static PolyApproxRegistry& instance() {
+            static PolyApproxRegistry registry;
+            return registry;
+        }
+
+
+        // the registered table or nullptr
+        pointer find(const std::string& name, unsigned part_count, Calculable range_min, Calculable range_max, Calculable dx=1e-3) const {
+            const key k(name, part_count, range_min, range_max, dx);
+            if (sealed.load(std::memory_order_acquire))
+                return lookup(k);
+            std::lock_guard<std::mutex> lock(mutex);
+            return lookup(k);
+        }
+
+
+        // the registered table, fitted now if it is missing - nullptr if it is missing and the registry is sealed
+        // concurrent requests of a missing table may fit it more than once, all of them get the first registered table
+        pointer get(const std::string& name, const std::function<Calculable(Calculable)>& src, unsigned part_count,
+                    Calculable range_min, Calculable range_max, Calculable dx=1e-3) {
+            pointer found = find(name, part_count, range_min, range_max, dx);
+            if (found || sealed.load(std::memory_order_acquire))
+                return found;
+            pointer fitted = std::make_shared<const approx_type>(approx_type::template create<Calculable>(src, part_count, range_min, range_max, dx));
+            return insert(key(name, part_count, range_min, range_max, dx), fitted);
+        }
+
+
+        // fits all missing tables on the threads (one table per thread at a time), f.e. at start before seal()
+        void populate(const std::vector<request>& requests, unsigned threads=polyapprox_parallel::default_thread_count()) {
+            polyapprox_parallel::for_chunks(requests.size(), threads, [&](unsigned, std::size_t begin, std::size_t end) {
+                for (std::size_t i=begin;i<end;i++) {
+                    const request& r = requests[i];
+                    get(r.name, r.src, r.part_count, r.range_min, r.range_max, r.dx);
+                }
+            });
+        }
+
+
+        // no more tables are added, lookups do not lock from now on
+        void seal() noexcept {
+            std::lock_guard<std::mutex> lock(mutex);
+            sealed.store(true, std::memory_order_release);
+        }
+
+
+        bool isSealed() const noexcept {
+            return sealed.load(std::memory_order_acquire);
+        }
+
+
+        std::size_t size() const {
+            if (sealed.load(std::memory_order_acquire))
+                return tables.size();
+            std::lock_guard<std::mutex> lock(mutex);
+            return tables.size();
+        }
+
+
+    private:
+
+        using key = std::tuple<std::string, unsigned, Calculable, Calculable, Calculable>;
+
+        std::map<key, pointer> tables;
+        mutable std::mutex mutex;
+        std::atomic<bool> sealed{false};
+
+
+        pointer lookup(const key& k) const {
+            auto found = tables.find(k);
+            return (found != tables.end()) ? found->second : nullptr;
+        }
+
+
+        pointer insert(const key& k, const pointer& fitted) {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (sealed.load(std::memory_order_relaxed))
+                return lookup(k);
+            return tables.emplace(k, fitted).first->second;
+        }
+
+};
+
+#endif
@@ -0,0 +1,207 @@
+/****************************************************************************************
+
+                                       MIT License
+
+               Copyright (c) 2025 Pawel Bielecki [pbielecki2000@gmail.com]
+
+       Permission is hereby granted, free of charge, to any person obtaining a copy
+      of this software and associated documentation files (the "Software"), to deal
+       in the Software without restriction, including without limitation the rights
+        to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+          copies of the Software, and to permit persons to whom the Software is
+                 furnished to do so, subject to the following conditions:
+
+      The above copyright notice and this permission notice shall be included in all
+                     copies or substantial portions of the Software.
+
+        THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+         IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+       FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+          AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+      LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+      OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+                                        SOFTWARE.
+
+****************************************************************************************/
+
+#ifndef POLY_APPROX_SIZING
+#define POLY_APPROX_SIZING
+
+#include <cmath>
+#include <limits>
+#include <vector>
+#include <array>
+#include <cstdint>
+#include <cstddef>
+#include <functional>
+#include <type_traits>
+
+#include "polyapprox.h"
+#include "cyclecounter.h"
+
+
+// Chooses the number of parts and the fitting mode of PolyApprox from an error target and a memory budget.
+namespace polyapprox_sizing {
+
+    // zero disables a limit, at least one of the errors has to be set
+    struct target {
+        double max_error = 0;
+        double max_ulps = 0;
+        std::size_t max_bytes = 0;
+    };
+
+
+    struct report {
+        bool met = false;
+        unsigned part_count = 0;
+        PolyApproxFit mode = PolyApproxFit::hermite;
+        double max_error = 0;
+        double max_ulps = 0;
+        std::size_t bytes = 0;
+        // average of the fastest calls for 64 arguments (cycle_counter units)
+        double cycles_per_call = 0;
+        // number of fitted candidates
+        unsigned fits = 0;
+    };
+
+
+    template<typename Storable>
+    struct result {
+        PolyApprox<Storable> approx;
+        report info;
+    };
+
+
+    // unit of the last place of y in Storable
+    template<typename Storable, typename std::enable_if<polyapprox_helpers::has_raw_buffer<Storable>::value, void>::type* = nullptr>
+    double ulp(double) {
+        return (double)Storable::buf_cast(1);
+    }
+
+
+    template<typename Storable, typename std::enable_if<!polyapprox_helpers::has_raw_buffer<Storable>::value, void>::type* = nullptr>
+    double ulp(double y) {
+        const Storable value = (Storable)std::abs(y);
+        return (double)(std::nextafter(value, std::numeric_limits<Storable>::infinity()) - value);
+    }
+
+
+    // the arguments and the reference values are shared by all candidates
+    // errors in ulps are counted in the unit of the largest |y| of the range (for floating point types) - the unit of a value
+    // near a zero of the function is far below the rounding of the polynomial, so a target counted in it could not be met
+    template<typename Storable>
+    struct error_grid {
+        std::vector<Storable> x;
+        std::vector<double> y;
+        double unit = 0;
+
+        template<typename Calculable>
+        error_grid(const std::function<Calculable(Calculable)>& src, Calculable range_min, Calculable range_max, unsigned samples) {
+            double magnitude = 0;
+            for (unsigned i=0;i<=samples;i++) {
+                const Storable arg = Storable(range_min + (range_max - range_min) * i / samples);
+                // arguments are rounded to Storable, they can leave the range
+                if (Calculable(arg) < range_min || Calculable(arg) > range_max) continue;
+                x.push_back(arg);
+                y.push_back((double)src(Calculable(arg)));
+                magnitude = (std::abs(y.back()) > magnitude) ? std::abs(y.back()) : magnitude;
+            }
+            unit = ulp<Storable>(magnitude);
+        }
+    };
+
+
+    template<typename Storable>
+    void measure_error(const PolyApprox<Storable>& approx, const error_grid<Storable>& grid, report& info) {
+        info.max_error = 0;
+        info.max_ulps = 0;
+        for (std::size_t i=0;i<grid.x.size();i++) {
+            const double error = std::abs((double)approx(grid.x[i]) - grid.y[i]);
+            info.max_error = (error > info.max_error) ? error : info.max_error;
+            info.max_ulps = (error / grid.unit > info.max_ulps) ? error / grid.unit : info.max_ulps;
+        }
+    }
+
+
+    inline bool meets(const report& info, const target& goal) {
+        return (goal.max_error <= 0 || info.max_error <= goal.max_error) && (goal.max_ulps <= 0 || info.max_ulps <= goal.max_ulps);
+    }
+
+
+    template<typename Storable>
+    double cycles_per_call(const PolyApprox<Storable>& approx, Storable range_min, Storable range_max) {
+        constexpr const unsigned samples = 64;
+        double sum = 0;
+        for (unsigned i=0;i<samples;i++) {
+            const Storable x = range_min + (range_max - range_min) * Storable(double(i) / samples);
+            sum += cycle_counter::measure<Storable>([&approx](Storable arg) {return approx(arg);}, x, 8);
+        }
+        return sum / samples;
+    }
+
+
+    // the smallest part count (for every mode) with the error within the target - a doubling search, then bisection
+    // the error is sampled at 8 points per part of the largest candidate (at least 4096 points)
+    template<typename Storable, typename Calculable = double>
+    result<Storable> build(const std::function<Calculable(Calculable)>& src, Calculable range_min, Calculable range_max, const target& goal,
+                           Calculable dx=1e-3, unsigned max_part_count=1u << 16) {
+        constexpr const std::size_t part_bytes = sizeof(std::array<Storable, 5>);
+        if (goal.max_bytes)
+            max_part_count = (goal.max_bytes / part_bytes < max_part_count) ? goal.max_bytes / part_bytes : max_part_count;
+        max_part_count = max_part_count ? max_part_count : 1;
+        const unsigned samples = (8 * max_part_count > 4096) ? 8 * max_part_count : 4096;
+        const error_grid<Storable> grid(src, range_min, range_max, samples);
+
+        result<Storable> best;
+        unsigned fits = 0;
+        auto candidate = [&](unsigned part_count, PolyApproxFit mode, result<Storable>& out) {
+            out.approx = PolyApprox<Storable>::template create<Calculable>(src, part_count, range_min, range_max, dx, mode);
+            out.info.part_count = part_count;
+            out.info.mode = mode;
+            measure_error<Storable>(out.approx, grid, out.info);
+            out.info.met = meets(out.info, goal);
+            fits++;
+            return out.info.met;
+        };
+
+        const PolyApproxFit modes[] = {PolyApproxFit::hermite, PolyApproxFit::chebyshev, PolyApproxFit::minimax};
+        for (PolyApproxFit mode: modes) {
+            // no mode can beat the best one with more parts
+            unsigned limit = best.info.met ? best.info.part_count - 1 : max_part_count;
+            if (!limit) break;
+            result<Storable> current;
+            unsigned low = 0, high = 1;
+            while (high < limit && !candidate(high, mode, current)) {
+                low = high;
+                high = (2 * high < limit) ? 2 * high : limit;
+            }
+            if (high == limit && !current.info.met && current.info.part_count != limit)
+                candidate(high, mode, current);
+            if (!current.info.met) {
+                // the most accurate candidate within the budget is kept if no mode meets the target
+                if (!best.info.met && (!best.info.part_count || current.info.max_error < best.info.max_error))
+                    best = current;
+                continue;
+            }
+            result<Storable> probe;
+            while (high - low > 1) {
+                const unsigned middle = low + (high - low) / 2;
+                if (candidate(middle, mode, probe)) {
+                    high = middle;
+                    current = probe;
+                } else {
+                    low = middle;
+                }
+            }
+            best = current;
+        }
+
+        best.info.fits = fits;
+        best.info.bytes = best.info.part_count * part_bytes;
+        best.info.cycles_per_call = cycles_per_call<Storable>(best.approx, Storable(range_min), Storable(range_max));
+        return best;
+    }
+
+}
+
+#endif
@@ -34,6 +34,8 @@
 #include <cstdint>
 #include <type_traits>
 
+#include "mathstats.h"
+
 #ifndef __glibc_unlikely
 #define __glibc_unlikely
 #endif
@@ -57,14 +59,33 @@ namespace taylor {
     extern std::uint64_t pochhammer_counters[];
 
     extern bool constants_initilized;
-    extern std::size_t loop_counter;
+    extern thread_local std::size_t loop_counter;
 
     #ifdef TAYLOR_LOOP_COUNTER
-        #define TAYLOR_INCREMENT_LOOP_COUNTER {loop_counter++;}
+        #define TAYLOR_INCREMENT_LOOP_COUNTER {loop_counter++; MATH_STATS_ITERATIONS(1);}
     #else
-        #define TAYLOR_INCREMENT_LOOP_COUNTER {}
+        #define TAYLOR_INCREMENT_LOOP_COUNTER {MATH_STATS_ITERATIONS(1);}
     #endif
 
+    // functions with a fixed sequence of operations - defined after the batch kernels
+    namespace constant_latency {
+        template<typename T, unsigned bits=0> T sin(T x);
+        template<typename T, unsigned bits=0> T cos(T x);
+        template<typename T, unsigned bits=0> std::pair<T, T> sincos(T x);
+        template<typename T, unsigned bits=0> T sqrt(T x);
+        template<typename T, unsigned bits=0> T asin(T x);
+        template<typename T, unsigned bits=0> T ln(T x);
+        template<typename T, unsigned bits=0> T log(T x);
+        template<typename T, unsigned bits=0> T exp(T x);
+        template<typename T, unsigned bits=0> T acos(T x);
+        template<typename T, unsigned bits=0> T tan(T x);
+        template<typename T, unsigned bits=0> T atan(T x);
+        template<typename T, unsigned bits=0> T atan2(T y, T x);
+        template<typename T, unsigned bits=0> T sinh(T x);
+        template<typename T, unsigned bits=0> T cosh(T x);
+        template<typename T, unsigned bits=0> T tanh(T x);
+    }
+
     template<typename T>
     struct has_shift_left {
     private:
@@ -112,15 +133,116 @@ namespace taylor {
     }
 
 
-    template<typename T, bool sine>
+    // --- series lengths ---
+    // Number of terms needed to get the first skipped term below 2^-bits.
+    // Used by the batch functions (for the full precision of a type) and by the precision parameter of the scalar functions.
+
+    constexpr static const unsigned max_series_terms = 32;
+
+
+    template<typename T>
+    constexpr14 unsigned precision_bits() {
+        double eps = (double)std::numeric_limits<T>::epsilon();
+        unsigned bits = 1;
+        while (eps < 1) {
+            eps *= 2;
+            bits++;
+        }
+        return bits;
+    }
+
+
+    // requested precision or the full precision of the type for bits == 0
+    template<typename T, unsigned bits>
+    constexpr14 unsigned target_bits() {
+        return bits ? bits : precision_bits<T>();
+    }
+
+
+    constexpr14 double pow2_neg(unsigned bits) {
+        double result = 1;
+        for (unsigned i=0;i<bits;i++)
+            result /= 2;
+        return result;
+    }
+
+
+    constexpr14 unsigned bounded_terms(unsigned terms) {
+        return (terms < max_series_terms) ? terms : max_series_terms;
+    }
+
+
+    // number of terms of sum(x^i / i!) for |x| <= x_max to get the first skipped term below 2^-bits
+    constexpr14 unsigned factorial_series_terms(double x_max, unsigned bits) {
+        const double eps = pow2_neg(bits);
+        double part = 1;
+        unsigned i = 0;
+        while (part >= eps) {
+            i++;
+            part *= x_max / i;
+        }
+        return i;
+    }
+
+
+    // number of terms of sum(c_i * x^i), |c_i| <= 1, for |x| <= x_max
+    constexpr14 unsigned geometric_series_terms(double x_max, unsigned bits) {
+        const double eps = pow2_neg(bits);
+        double part = 1;
+        unsigned i = 0;
+        while (part >= eps) {
+            i++;
+            part *= x_max;
+        }
+        return i;
+    }
+
+
+    // number of terms of sum(c_i * x^(2i+1)), |c_i| <= 1, for |x| <= x_max
+    constexpr14 unsigned odd_power_series_terms(double x_max, unsigned bits) {
+        const double eps = pow2_neg(bits);
+        const double x2 = x_max * x_max;
+        double part = x_max;
+        unsigned i = 0;
+        while (part >= eps) {
+            i++;
+            part *= x2;
+        }
+        return i;
+    }
+
+
+    // newton iterations for the square root starting with the given relative error
+    constexpr14 unsigned newton_sqrt_iterations(double error, unsigned bits) {
+        const double eps = pow2_neg(bits);
+        unsigned i = 0;
+        while (error >= eps) {
+            i++;
+            error = error * error / 2;
+        }
+        return i;
+    }
+
+
+    // true if the part is below the requested precision (never for bits == 0 - the full precision)
+    template<typename T, unsigned bits>
+    bool below_precision(T part) {
+        constexpr14 static const T tolerance = bits ? pow2_neg(bits) : 0;
+        return bits && ((part < 0) ? -part : part) < tolerance;
+    }
+
+
+    template<typename T, bool sine, unsigned bits=0>
     T base_trig_pos(T x) {
+        constexpr14 static const unsigned max_terms = bits ? factorial_series_terms(M_PI / 4, bits) : max_series_terms;
         T result = 0;
         T poly = sine ? x : (T)1;
         T x2 = x*x;
-        for (unsigned i=sine;i<gamma_tab_size;i+=2) {
+        for (unsigned i=sine;i<gamma_tab_size && i<max_terms;i+=2) {
             TAYLOR_INCREMENT_LOOP_COUNTER;
             if (__glibc_unlikely(poly <= 0)) break;
             T part = poly / gamma_tab[i];
+            if (below_precision<T, bits>(part)) break;
             T new_result = (i & 2) ? (result - part) : (result + part);
             if (__glibc_unlikely(result == new_result)) break;
             result = new_result;
@@ -130,7 +252,7 @@ namespace taylor {
     }
 
 
-    template<typename T>
+    template<typename T, unsigned bits=0>
     T base_cos(T x) {
         if (x < 0) x = -x;
         constexpr static const T pi2 = M_PI / 2;
@@ -139,26 +261,96 @@ namespace taylor {
         T rest = x - n * pi2;
         n &= 3;
         if (n & 1) rest = pi2 - rest;
-        T result = (rest > pi4) ? base_trig_pos<T, true>(pi2 - rest) : base_trig_pos<T, false>(rest);
+        T result = (rest > pi4) ? base_trig_pos<T, true, bits>(pi2 - rest) : base_trig_pos<T, false, bits>(rest);
         return (n == 1 || n == 2) ? -result : result;
     }
 
 
-    template<typename T>
+    template<typename T, unsigned bits=0>
     T sin(T x) {
+        MATH_STATS_SCOPE("taylor::sin", T)
+        #ifdef TAYLOR_CONSTANT_LATENCY
+        return constant_latency::sin<T, bits>(x);
+        #else
         constexpr static const T pi2 = M_PI / 2;
-        return base_cos<T>(x - pi2);
+        return base_cos<T, bits>(x - pi2);
+        #endif
     }
 
 
-    template<typename T>
+    template<typename T, unsigned bits=0>
     T cos(T x) {
-        return base_cos<T>(x);
+        MATH_STATS_SCOPE("taylor::cos", T)
+        #ifdef TAYLOR_CONSTANT_LATENCY
+        return constant_latency::cos<T, bits>(x);
+        #else
+        return base_cos<T, bits>(x);
+        #endif
+    }
+
+
+    // both series in one loop - independent chains can be interleaved by the CPU
+    template<typename T, unsigned bits=0>
+    void base_sincos_pos(T x, T& sine, T& cosine) {
+        constexpr14 static const unsigned max_terms = bits ? factorial_series_terms(M_PI / 4, bits) : max_series_terms;
+        T sin_result = 0;
+        T cos_result = 0;
+        T sin_poly = x;
+        T cos_poly = 1;
+        T x2 = x*x;
+        for (unsigned i=0;i+1<gamma_tab_size && i<max_terms;i+=2) {
+            TAYLOR_INCREMENT_LOOP_COUNTER;
+            if (__glibc_unlikely(cos_poly <= 0)) break;
+            T sin_part = sin_poly / gamma_tab[i+1];
+            T cos_part = cos_poly / gamma_tab[i];
+            if (below_precision<T, bits>(cos_part)) break;
+            T new_sin_result = (i & 2) ? (sin_result - sin_part) : (sin_result + sin_part);
+            T new_cos_result = (i & 2) ? (cos_result - cos_part) : (cos_result + cos_part);
+            if (__glibc_unlikely(sin_result == new_sin_result && cos_result == new_cos_result)) break;
+            sin_result = new_sin_result;
+            cos_result = new_cos_result;
+            sin_poly *= x2;
+            cos_poly *= x2;
+        }
+        sine = sin_result;
+        cosine = cos_result;
+    }
+
+
+    // returns {sin(x), cos(x)} with a single argument reduction
+    template<typename T, unsigned bits=0>
+    std::pair<T, T> sincos(T x) {
+        MATH_STATS_SCOPE("taylor::sincos", T)
+        #ifdef TAYLOR_CONSTANT_LATENCY
+        return constant_latency::sincos<T, bits>(x);
+        #else
+        constexpr static const T pi2 = M_PI / 2;
+        constexpr static const T pi4 = M_PI / 4;
+        bool neg = x < 0;
+        if (neg) x = -x;
+        unsigned n = std::floor(x / pi2);
+        T rest = x - n * pi2;
+        T s, c;
+        if (rest > pi4)
+            base_sincos_pos<T, bits>(pi2 - rest, c, s);
+        else
+            base_sincos_pos<T, bits>(rest, s, c);
+        switch (n & 3) {
+            case 1: std::swap(s, c); c = -c; break;
+            case 2: s = -s; c = -c; break;
+            case 3: std::swap(s, c); s = -s; break;
+        }
+        return std::make_pair(neg ? -s : s, c);
+        #endif
     }
 
 
     template<typename T>
     T sqrt(T s) {
+        MATH_STATS_SCOPE("taylor::sqrt", T)
+        #ifdef TAYLOR_CONSTANT_LATENCY
+        return constant_latency::sqrt<T>(s);
+        #else
         if (s == 0 || s == 1) return T(s);
         constexpr14 static const unsigned max_iter = std::round(std::sqrt(
             (std::log2((double)std::numeric_limits<T>::max()) - std::log2((double)std::numeric_limits<T>::min())) / 2
@@ -173,17 +365,22 @@ namespace taylor {
             x = nx;
         };
         return x;
+        #endif
     }
 
 
-    template<typename T>
+    // used below the crossover point (< 0.75 for all types)
+    template<typename T, unsigned bits=0>
     T base_asin1(T x) {
+        constexpr static const unsigned target = bits ? bits + 2 : 0; // tail of the series below 2.3 * first skipped part
+        constexpr14 static const unsigned max_terms = bits ? odd_power_series_terms(0.75, target) : max_series_terms;
         T result = 0;
         T poly = x;
         T x2 = x*x;
-        for (unsigned i=0;i<asin_divisors_tab_size;i++) {
+        for (unsigned i=0;i<asin_divisors_tab_size && i<max_terms;i++) {
             TAYLOR_INCREMENT_LOOP_COUNTER;
             T part = div_by_pow2<T>(pochhammer_counters[i] * poly / asin_divisors_tab[i], i);
+            if (below_precision<T, target>(part)) break;
             T new_result = result + part;
             if (__glibc_unlikely(result == new_result)) break;
             result = new_result;
@@ -193,22 +390,32 @@ namespace taylor {
     }
 
 
-    template<typename T>
-    T base_asin2(T x) {
-        constexpr static const T pi2 = M_PI / 2;
+    // acos(x) used above the crossover point (> 0.25 for all types), parts are below ((1-x)/2)^i
+    template<typename T, unsigned bits=0>
+    T base_acos2(T x) {
+        constexpr static const unsigned target = bits ? bits + 1 : 0; // tail of the series below 1.6 * first skipped part
+        constexpr14 static const unsigned max_terms = bits ? geometric_series_terms(0.375, target) : max_series_terms;
         x = 1-x;
         T result = 0;
         T coeff = sqrt<T>(mul_by_pow2<T>(x, 1));
         T poly = 1;
-        for (unsigned i=0;i<asin_divisors_tab_size;i++) {
+        for (unsigned i=0;i<asin_divisors_tab_size && i<max_terms;i++) {
             TAYLOR_INCREMENT_LOOP_COUNTER;
             T part = div_by_pow2<T>(pochhammer_counters[i] * poly / asin_divisors_tab[i], i << 1);
+            if (below_precision<T, target>(part)) break;
             T new_result = result + part;
             if (__glibc_unlikely(result == new_result)) break;
             result = new_result;
             poly *= x;
         }
-        return pi2 - coeff * result;
+        return coeff * result;
+    }
+
+
+    template<typename T, unsigned bits=0>
+    T base_asin2(T x) {
+        constexpr static const T pi2 = M_PI / 2;
+        return pi2 - base_acos2<T, bits>(x);
     }
 
 
@@ -228,30 +435,57 @@ namespace taylor {
     }
 
 
-    template<typename T>
+    template<typename T, unsigned bits=0>
     T base_asin_pos(T x) {
         static const T half = calculate_asin_half<T>();
-        return (x < half) ? base_asin1<T>(x) : base_asin2<T>(x);
+        return (x < half) ? base_asin1<T, bits>(x) : base_asin2<T, bits>(x);
     }
 
 
-    template<typename T>
+    template<typename T, unsigned bits=0>
     T asin(T x) {
-        return (x < 0) ? -base_asin_pos(-x) : base_asin_pos(x);
+        MATH_STATS_SCOPE("taylor::asin", T)
+        #ifdef TAYLOR_CONSTANT_LATENCY
+        return constant_latency::asin<T, bits>(x);
+        #else
+        return (x < 0) ? -base_asin_pos<T, bits>(-x) : base_asin_pos<T, bits>(x);
+        #endif
     }
 
 
-    template<typename T>
+    // near |x| = 1 the result comes directly from the series of base_acos2 - no cancellation with pi/2
+    template<typename T, unsigned bits=0>
+    T acos(T x) {
+        MATH_STATS_SCOPE("taylor::acos", T)
+        #ifdef TAYLOR_CONSTANT_LATENCY
+        return constant_latency::acos<T, bits>(x);
+        #else
+        constexpr static const T pi = M_PI;
+        constexpr static const T pi2 = M_PI / 2;
+        static const T half = calculate_asin_half<T>();
+        bool neg = x < 0;
+        if (neg) x = -x;
+        if (x < half) return neg ? pi2 + base_asin1<T, bits>(x) : pi2 - base_asin1<T, bits>(x);
+        T result = base_acos2<T, bits>(x);
+        return neg ? pi - result : result;
+        #endif
+    }
+
+
+    // x in (0.2, 1.5) - parts are below 0.8^i
+    template<typename T, unsigned bits=0>
     T ln_small(T x) {
         x -= 1;
         T poly = x;
         T result = 0;
-        constexpr14 static const unsigned max_iter = std::round(
+        constexpr static const unsigned target = bits ? bits + 3 : 0; // tail of the series below 5 * first skipped part
+        constexpr14 static const unsigned max_iter = bits ? geometric_series_terms(0.8, target) + 1 : std::round(
             (std::log2((double)std::numeric_limits<T>::max()) - std::log2((double)std::numeric_limits<T>::min()))
         );
         for (unsigned i=1;i<max_iter;i++) {
             TAYLOR_INCREMENT_LOOP_COUNTER;
             T part = poly / i;
+            if (below_precision<T, target>(part)) break;
             T new_result = (i & 1) ? (result + part) : (result - part);
             if (__glibc_unlikely(result == new_result)) break;
             result = new_result;
@@ -278,26 +512,35 @@ namespace taylor {
     // }
 
 
-    template<typename T>
+    template<typename T, unsigned bits=0>
     T ln(T x) {
-        return ((x > 0.2) && x < (T)1.5f) ? ln_small<T>(x) : mul_by_pow2<T>(ln(sqrt<T>(x)), 1); //(ln<T>(x-1) - ln_part2<T>(x));
+        MATH_STATS_SCOPE("taylor::ln", T)
+        #ifdef TAYLOR_CONSTANT_LATENCY
+        return constant_latency::ln<T, bits>(x);
+        #else
+        return ((x > 0.2) && x < (T)1.5f) ? ln_small<T, bits>(x) : mul_by_pow2<T>(ln<T, bits>(sqrt<T>(x)), 1); //(ln<T>(x-1) - ln_part2<T>(x));
+        #endif
     }
 
 
-    template<typename T>
+    template<typename T, unsigned bits=0>
     T log(T x) {
-        return ln<T>(x);
+        MATH_STATS_SCOPE("taylor::log", T)
+        return ln<T, bits>(x);
     }
 
 
-    template<typename T>
+    // x in [0, 1]
+    template<typename T, unsigned bits=0>
     T exp_small_pos(T x) {
+        constexpr14 static const unsigned max_terms = bits ? factorial_series_terms(1, bits) : max_series_terms;
         T poly = 1;
         T result = 0;
-        for (unsigned i=0;i<gamma_tab_size;i++) {
+        for (unsigned i=0;i<gamma_tab_size && i<max_terms;i++) {
             TAYLOR_INCREMENT_LOOP_COUNTER;
             T part = poly / gamma_tab[i];
             if (__glibc_unlikely(part <= 0)) return result;
+            if (below_precision<T, bits>(part)) return result;
             T new_result = result + part;
             if (__glibc_unlikely(result == new_result)) return result;
             result = new_result;
@@ -323,16 +566,755 @@ namespace taylor {
     }
 
 
-    template<typename T>
+    template<typename T, unsigned bits=0>
     T exp(T x) {
+        MATH_STATS_SCOPE("taylor::exp", T)
+        #ifdef TAYLOR_CONSTANT_LATENCY
+        return constant_latency::exp<T, bits>(x);
+        #else
         if (x == 0) return 1;
-        if (x < 0) return 1 / exp<T>(-x);
-        if (x <= 1) return exp_small_pos<T>(x);
+        if (x < 0) return 1 / exp<T, bits>(-x);
+        if (x <= 1) return exp_small_pos<T, bits>(x);
         unsigned long long int n = std::floor(x);
         T rest = x - n;
         static T exp1 = 0;
         if (__glibc_unlikely(exp1 == 0)) exp1 = exp_small_pos<T>(1);
-        return exp_small_pos<T>(rest) * pown<T>(exp1, n);
+        return exp_small_pos<T, bits>(rest) * pown<T>(exp1, n);
+        #endif
+    }
+
+
+    template<typename T, unsigned bits=0>
+    T tan(T x) {
+        MATH_STATS_SCOPE("taylor::tan", T)
+        #ifdef TAYLOR_CONSTANT_LATENCY
+        return constant_latency::tan<T, bits>(x);
+        #else
+        std::pair<T, T> sc = sincos<T, bits>(x);
+        return sc.first / sc.second;
+        #endif
+    }
+
+
+    // atan(x) for 0 <= x <= tan(pi/8) - alternating series, the error is below the first skipped part
+    template<typename T, unsigned bits=0>
+    T base_atan_small(T x) {
+        constexpr14 static const unsigned max_terms = bits ? odd_power_series_terms(0.41421356237309503, bits) : max_series_terms;
+        T result = 0;
+        T poly = x;
+        T x2 = x*x;
+        for (unsigned i=0;i<max_terms;i++) {
+            TAYLOR_INCREMENT_LOOP_COUNTER;
+            T part = poly / ((i << 1) + 1);
+            if (below_precision<T, bits>(part)) break;
+            T new_result = (i & 1) ? (result - part) : (result + part);
+            if (__glibc_unlikely(result == new_result)) break;
+            result = new_result;
+            poly *= x2;
+        }
+        return result;
+    }
+
+
+    // atan(num / den) for 0 <= num <= den, den > 0 - one division
+    // above tan(pi/8) the argument is moved by pi/4: atan(t) = pi/4 - atan((1-t) / (1+t))
+    template<typename T, unsigned bits=0>
+    T base_atan_frac(T num, T den) {
+        constexpr static const T pi4 = M_PI / 4;
+        constexpr static const T tan_pi8 = 0.41421356237309503;
+        if (num <= tan_pi8 * den) return base_atan_small<T, bits>(num / den);
+        return pi4 - base_atan_small<T, bits>((den - num) / (num + den));
+    }
+
+
+    // |x| > 1 is folded with atan(x) = pi/2 - atan(1/x)
+    template<typename T, unsigned bits=0>
+    T atan(T x) {
+        MATH_STATS_SCOPE("taylor::atan", T)
+        #ifdef TAYLOR_CONSTANT_LATENCY
+        return constant_latency::atan<T, bits>(x);
+        #else
+        constexpr static const T pi2 = M_PI / 2;
+        bool neg = x < 0;
+        if (neg) x = -x;
+        T result = (x > 1) ? pi2 - base_atan_frac<T, bits>(1, x) : base_atan_frac<T, bits>(x, 1);
+        return neg ? -result : result;
+        #endif
+    }
+
+
+    template<typename T, unsigned bits=0>
+    T atan2(T y, T x) {
+        MATH_STATS_SCOPE("taylor::atan2", T)
+        #ifdef TAYLOR_CONSTANT_LATENCY
+        return constant_latency::atan2<T, bits>(y, x);
+        #else
+        constexpr static const T pi = M_PI;
+        constexpr static const T pi2 = M_PI / 2;
+        T ax = (x < 0) ? -x : x;
+        T ay = (y < 0) ? -y : y;
+        if (__glibc_unlikely(ax == 0 && ay == 0)) return 0;
+        T result = (ay > ax) ? pi2 - base_atan_frac<T, bits>(ax, ay) : base_atan_frac<T, bits>(ay, ax);
+        if (x < 0) result = pi - result;
+        return (y < 0) ? -result : result;
+        #endif
+    }
+
+
+    // both series in one loop for x in [0, 1] - no alternating signs
+    template<typename T, unsigned bits=0>
+    void base_sinhcosh_pos(T x, T& sinh_result, T& cosh_result) {
+        constexpr14 static const unsigned max_terms = bits ? factorial_series_terms(1, bits) : max_series_terms;
+        T s = 0;
+        T c = 0;
+        T sinh_poly = x;
+        T cosh_poly = 1;
+        T x2 = x*x;
+        for (unsigned i=0;i+1<gamma_tab_size && i<max_terms;i+=2) {
+            TAYLOR_INCREMENT_LOOP_COUNTER;
+            T sinh_part = sinh_poly / gamma_tab[i+1];
+            T cosh_part = cosh_poly / gamma_tab[i];
+            if (below_precision<T, bits>(cosh_part)) break;
+            T new_s = s + sinh_part;
+            T new_c = c + cosh_part;
+            if (__glibc_unlikely(s == new_s && c == new_c)) break;
+            s = new_s;
+            c = new_c;
+            sinh_poly *= x2;
+            cosh_poly *= x2;
+        }
+        sinh_result = s;
+        cosh_result = c;
+    }
+
+
+    // below 1 the series avoids the cancellation of (e^x - e^-x) / 2
+    template<typename T, unsigned bits=0>
+    T sinh(T x) {
+        MATH_STATS_SCOPE("taylor::sinh", T)
+        #ifdef TAYLOR_CONSTANT_LATENCY
+        return constant_latency::sinh<T, bits>(x);
+        #else
+        bool neg = x < 0;
+        if (neg) x = -x;
+        T result;
+        if (x <= 1) {
+            T c;
+            base_sinhcosh_pos<T, bits>(x, result, c);
+        } else {
+            T e = exp<T, bits>(x);
+            result = div_by_pow2<T>(e - 1 / e, 1);
+        }
+        return neg ? -result : result;
+        #endif
+    }
+
+
+    template<typename T, unsigned bits=0>
+    T cosh(T x) {
+        MATH_STATS_SCOPE("taylor::cosh", T)
+        #ifdef TAYLOR_CONSTANT_LATENCY
+        return constant_latency::cosh<T, bits>(x);
+        #else
+        if (x < 0) x = -x;
+        if (x <= 1) {
+            T s, c;
+            base_sinhcosh_pos<T, bits>(x, s, c);
+            return c;
+        }
+        T e = exp<T, bits>(x);
+        return div_by_pow2<T>(e + 1 / e, 1);
+        #endif
+    }
+
+
+    // above 1: tanh(x) = (1 - q) / (1 + q), q = e^-2x stays in the range of the fixed point types
+    // saturates to 1 where 1 - tanh(x) = 2q / (1 + q) is below the precision of the type
+    template<typename T, unsigned bits=0>
+    T tanh(T x) {
+        MATH_STATS_SCOPE("taylor::tanh", T)
+        #ifdef TAYLOR_CONSTANT_LATENCY
+        return constant_latency::tanh<T, bits>(x);
+        #else
+        constexpr14 static const T saturation = (target_bits<T, bits>() + 1) * M_LN2 / 2;
+        bool neg = x < 0;
+        if (neg) x = -x;
+        T result;
+        if (x >= saturation) {
+            result = 1;
+        } else if (x <= 1) {
+            T s, c;
+            base_sinhcosh_pos<T, bits>(x, s, c);
+            result = s / c;
+        } else {
+            T inv = 1 / exp<T, bits>(x);
+            T q = inv * inv;
+            result = (1 - q) / (1 + q);
+        }
+        return neg ? -result : result;
+        #endif
+    }
+
+
+
+    // --- batch functions ---
+    // Every lane runs the same number of terms (the worst case for the type),
+    // so the inner loops over lanes have no early exits and can be vectorized.
+    // The fixed term counts are not added to loop_counter - the kernels touch no shared state.
+    // Arrays may be split into chunks (preferably multiples of TAYLOR_BATCH_LANES)
+    // and processed by separate threads - batch functions share only read-only tables.
+
+    #ifndef TAYLOR_BATCH_LANES
+    #define TAYLOR_BATCH_LANES 8
+    #endif
+
+    constexpr static const unsigned batch_lanes = TAYLOR_BATCH_LANES;
+    template<typename T>
+    constexpr14 unsigned max_pow2_shift() {
+        unsigned shift = 1;
+        while ((shift << 1) < (unsigned)std::numeric_limits<T>::digits)
+            shift <<= 1;
+        return shift;
+    }
+
+
+    template<typename T>
+    struct batch_tables {
+
+        T inv_factorial[max_series_terms];       // 1 / i!
+        T sin_coefficients[max_series_terms];    // 1 / (2i+1)!
+        T cos_coefficients[max_series_terms];    // 1 / (2i)!
+        T inv_odd[max_series_terms];             // 1 / (2i+1)
+        T asin_coefficients[max_series_terms];   // (2i)! / (4^i (i!)^2 (2i+1))
+
+        batch_tables() {
+            double factorial[2*max_series_terms];
+            factorial[0] = 1;
+            for (unsigned i=1;i<2*max_series_terms;i++)
+                factorial[i] = factorial[i-1] * i;
+            double asin_c = 1;
+            for (unsigned i=0;i<max_series_terms;i++) {
+                if (i) asin_c *= (double)(2*i-1) * (2*i-1) / ((double)(2*i) * (2*i+1));
+                inv_factorial[i] = 1 / factorial[i];
+                sin_coefficients[i] = 1 / factorial[2*i+1];
+                cos_coefficients[i] = 1 / factorial[2*i];
+                inv_odd[i] = 1 / (double)(2*i+1);
+                asin_coefficients[i] = asin_c;
+            }
+        }
+
+        static const batch_tables& get() {
+            static const batch_tables tables;
+            return tables;
+        }
+
+    };
+
+
+    template<typename T>
+    typename std::enable_if<std::is_floating_point<T>::value, T>::type split_pow2(T x, int& k) {
+        int e;
+        T m = std::frexp(x, &e);
+        k = e - 1;
+        return m * 2;
+    }
+
+
+    // x = m * 2^k, m in [1, 2) - fixed number of steps for non floating types
+    template<typename T>
+    typename std::enable_if<!std::is_floating_point<T>::value, T>::type split_pow2(T x, int& k) {
+        k = 0;
+        for (unsigned s=max_pow2_shift<T>();s>0;s>>=1) {
+            T shifted = div_by_pow2<T>(x, s);
+            bool down = shifted >= 1;
+            x = down ? shifted : x;
+            k += down ? (int)s : 0;
+        }
+        for (unsigned s=max_pow2_shift<T>();s>0;s>>=1) {
+            bool up = x < div_by_pow2<T>(T(2), s);
+            x = up ? mul_by_pow2<T>(x, s) : x;
+            k -= up ? (int)s : 0;
+        }
+        return x;
+    }
+
+
+    template<typename T>
+    typename std::enable_if<std::is_floating_point<T>::value, T>::type scale_pow2(T x, int k) {
+        return std::ldexp(x, k);
+    }
+
+
+    template<typename T>
+    typename std::enable_if<!std::is_floating_point<T>::value, T>::type scale_pow2(T x, int k) {
+        constexpr14 static const int max_shift = std::numeric_limits<T>::digits;
+        if (k > max_shift) k = max_shift;
+        if (k < -max_shift) k = -max_shift;
+        return (k >= 0) ? mul_by_pow2<T>(x, k) : div_by_pow2<T>(x, -k);
+    }
+
+
+    template<typename T, typename Kernel>
+    void for_each_block(const T* in, T* out, std::size_t n, Kernel kernel) {
+        std::size_t i = 0;
+        for (;i+batch_lanes<=n;i+=batch_lanes)
+            kernel(in + i, out + i);
+        if (i < n) {
+            T tail_in[batch_lanes];
+            T tail_out[batch_lanes];
+            for (unsigned j=0;j<batch_lanes;j++)
+                tail_in[j] = (i + j < n) ? in[i+j] : in[i];
+            kernel(tail_in, tail_out);
+            for (unsigned j=0;i+j<n;j++)
+                out[i+j] = tail_out[j];
+        }
+    }
+
+
+    template<typename T, unsigned lanes=batch_lanes, unsigned bits=0>
+    void sincos_block(const T* in, T* sine, T* cosine) {
+        constexpr static const T pi2 = M_PI / 2;
+        constexpr static const T pi4 = M_PI / 4;
+        constexpr14 static const unsigned terms = bounded_terms((factorial_series_terms(M_PI / 4, target_bits<T, bits>()) + 1) / 2);
+        const batch_tables<T>& tab = batch_tables<T>::get();
+        T r[lanes], r2[lanes], s[lanes], c[lanes];
+        unsigned q[lanes];
+        bool neg[lanes], flip[lanes];
+
+        for (unsigned l=0;l<lanes;l++) {
+            T x = in[l];
+            neg[l] = x < 0;
+            x = neg[l] ? -x : x;
+            unsigned n = std::floor(x / pi2);
+            T rest = x - n * pi2;
+            flip[l] = rest > pi4;
+            r[l] = flip[l] ? pi2 - rest : rest;
+            r2[l] = r[l] * r[l];
+            q[l] = n & 3;
+            s[l] = tab.sin_coefficients[terms-1];
+            c[l] = tab.cos_coefficients[terms-1];
+        }
+
+        for (unsigned i=terms-1;i-->0;) {
+            for (unsigned l=0;l<lanes;l++) {
+                s[l] = tab.sin_coefficients[i] - r2[l] * s[l];
+                c[l] = tab.cos_coefficients[i] - r2[l] * c[l];
+            }
+        }
+
+        for (unsigned l=0;l<lanes;l++) {
+            T sv = s[l] * r[l];
+            T cv = c[l];
+            T a = flip[l] ? cv : sv;    // sin of the quadrant rest
+            T b = flip[l] ? sv : cv;    // cos of the quadrant rest
+            T rs = (q[l] & 1) ? b : a;
+            T rc = (q[l] & 1) ? a : b;
+            rs = (q[l] & 2) ? -rs : rs;
+            rc = ((q[l] + 1) & 2) ? -rc : rc;
+            sine[l] = neg[l] ? -rs : rs;
+            cosine[l] = rc;
+        }
+    }
+
+
+    template<typename T, unsigned lanes=batch_lanes, unsigned bits=0>
+    void exp_block(const T* in, T* out) {
+        constexpr static const T ln2 = M_LN2;
+        constexpr static const T inv_ln2 = 1 / M_LN2;
+        constexpr14 static const unsigned terms = bounded_terms(factorial_series_terms(M_LN2, target_bits<T, bits>()));
+        const batch_tables<T>& tab = batch_tables<T>::get();
+        T r[lanes], e[lanes];
+        int k[lanes];
+
+        for (unsigned l=0;l<lanes;l++) {
+            k[l] = std::floor(in[l] * inv_ln2);
+            r[l] = in[l] - k[l] * ln2;
+            e[l] = tab.inv_factorial[terms-1];
+        }
+
+        for (unsigned i=terms-1;i-->0;) {
+            for (unsigned l=0;l<lanes;l++)
+                e[l] = tab.inv_factorial[i] + r[l] * e[l];
+        }
+
+        for (unsigned l=0;l<lanes;l++)
+            out[l] = scale_pow2<T>(e[l], k[l]);
+    }
+
+
+    template<typename T, unsigned lanes=batch_lanes, unsigned bits=0>
+    void ln_block(const T* in, T* out) {
+        constexpr static const T ln2 = M_LN2;
+        constexpr static const T sqrt2 = M_SQRT2;
+        // ln(m) = 2 atanh((m-1) / (m+1)), m in [1/sqrt(2), sqrt(2)]
+        // calculated for |m-1| as |m-1| -+ |m-1| z + 2 z (atanh(z)/z - 1) - the leading term is exact and the rounded parts
+        // are non negative and small, so the error stays relative near m = 1 (a quotient rounded to the type would not)
+        constexpr14 static const unsigned terms = bounded_terms(odd_power_series_terms((M_SQRT2 - 1) / (M_SQRT2 + 1), target_bits<T, bits>()));
+        const batch_tables<T>& tab = batch_tables<T>::get();
+        T d[lanes], z[lanes], z2[lanes], a[lanes];
+        int k[lanes];
+        bool neg[lanes];
+
+        for (unsigned l=0;l<lanes;l++) {
+            T m = split_pow2<T>(in[l], k[l]);
+            bool half = m > sqrt2;
+            m = half ? div_by_pow2<T>(m, 1) : m;
+            k[l] += half;
+            neg[l] = m < 1;
+            d[l] = neg[l] ? 1 - m : m - 1;
+            z[l] = d[l] / (m + 1);
+            z2[l] = z[l] * z[l];
+            a[l] = (terms > 1) ? tab.inv_odd[terms-1] : T(0);
+        }
+
+        for (unsigned i=terms-1;i-->1;) {
+            for (unsigned l=0;l<lanes;l++)
+                a[l] = tab.inv_odd[i] + z2[l] * a[l];
+        }
+
+        for (unsigned l=0;l<lanes;l++) {
+            T dz = d[l] * z[l];
+            T result = (neg[l] ? d[l] + dz : d[l] - dz) + mul_by_pow2<T>(z[l] * (z2[l] * a[l]), 1);
+            out[l] = (neg[l] ? -result : result) + k[l] * ln2;
+        }
+    }
+
+
+    template<typename T, unsigned lanes=batch_lanes, unsigned bits=0>
+    void sqrt_block(const T* in, T* out) {
+        // initial guess 0.6 + 0.4 m has relative error below 0.1 for m in [1, 4)
+        constexpr14 static const unsigned iterations = newton_sqrt_iterations(0.1, target_bits<T, bits>());
+        constexpr static const T guess_a = 0.6;
+        constexpr static const T guess_b = 0.4;
+        T m[lanes], y[lanes];
+        int k[lanes];
+
+        for (unsigned l=0;l<lanes;l++) {
+            m[l] = split_pow2<T>(in[l], k[l]);
+            bool odd = k[l] & 1;
+            m[l] = odd ? mul_by_pow2<T>(m[l], 1) : m[l];
+            k[l] -= odd;
+            y[l] = guess_a + guess_b * m[l];
+        }
+
+        for (unsigned i=0;i<iterations;i++) {
+            for (unsigned l=0;l<lanes;l++)
+                y[l] = div_by_pow2<T>(y[l] + m[l] / y[l], 1);
+        }
+
+        for (unsigned l=0;l<lanes;l++)
+            out[l] = (in[l] == 0) ? T(0) : scale_pow2<T>(y[l], k[l] / 2);
+    }
+
+
+    template<typename T, unsigned lanes=batch_lanes, unsigned bits=0>
+    void asin_block(const T* in, T* out) {
+        constexpr static const T pi2 = M_PI / 2;
+        constexpr static const T half = 0.5;
+        // asin(x) = pi/2 - 2 asin(sqrt((1-x)/2)) for x > 0.5
+        constexpr14 static const unsigned terms = bounded_terms(odd_power_series_terms(0.5, target_bits<T, bits>()));
+        const batch_tables<T>& tab = batch_tables<T>::get();
+        T y[lanes], y2[lanes], a[lanes], t[lanes];
+        bool neg[lanes], big[lanes];
+
+        for (unsigned l=0;l<lanes;l++) {
+            neg[l] = in[l] < 0;
+            y[l] = neg[l] ? -in[l] : in[l];
+            big[l] = y[l] > half;
+            t[l] = div_by_pow2<T>(1 - y[l], 1);
+        }
+
+        sqrt_block<T, lanes, bits>(t, t);
+
+        for (unsigned l=0;l<lanes;l++) {
+            y[l] = big[l] ? t[l] : y[l];
+            y2[l] = y[l] * y[l];
+            a[l] = tab.asin_coefficients[terms-1];
+        }
+
+        for (unsigned i=terms-1;i-->0;) {
+            for (unsigned l=0;l<lanes;l++)
+                a[l] = tab.asin_coefficients[i] + y2[l] * a[l];
+        }
+
+        for (unsigned l=0;l<lanes;l++) {
+            T result = y[l] * a[l];
+            result = big[l] ? pi2 - mul_by_pow2<T>(result, 1) : result;
+            out[l] = neg[l] ? -result : result;
+        }
+    }
+
+
+    // atan(num / den) for num, den >= 0 (0 for num = den = 0) - one division for every lane
+    // the quotient is folded to [0, 1] with atan(t) = pi/2 - atan(1/t) and above tan(pi/8) moved by pi/4
+    template<typename T, unsigned lanes=batch_lanes, unsigned bits=0>
+    void atan_frac_block(const T* num, const T* den, T* out) {
+        constexpr static const T pi2 = M_PI / 2;
+        constexpr static const T pi4 = M_PI / 4;
+        constexpr static const T tan_pi8 = 0.41421356237309503;
+        constexpr14 static const unsigned terms = bounded_terms(odd_power_series_terms(0.41421356237309503, target_bits<T, bits>()));
+        const batch_tables<T>& tab = batch_tables<T>::get();
+        T r[lanes], r2[lanes], a[lanes];
+        bool swap[lanes], shift[lanes];
+
+        for (unsigned l=0;l<lanes;l++) {
+            swap[l] = num[l] > den[l];
+            T n = swap[l] ? den[l] : num[l];
+            T d = swap[l] ? num[l] : den[l];
+            shift[l] = n > tan_pi8 * d;
+            T sn = shift[l] ? d - n : n;
+            T sd = shift[l] ? n + d : d;
+            r[l] = sn / ((sd == 0) ? T(1) : sd);
+            r2[l] = r[l] * r[l];
+            a[l] = tab.inv_odd[terms-1];
+        }
+
+        for (unsigned i=terms-1;i-->0;) {
+            for (unsigned l=0;l<lanes;l++)
+                a[l] = tab.inv_odd[i] - r2[l] * a[l];
+        }
+
+        for (unsigned l=0;l<lanes;l++) {
+            T result = r[l] * a[l];
+            result = shift[l] ? pi4 - result : result;
+            out[l] = swap[l] ? pi2 - result : result;
+        }
+    }
+
+
+    template<typename T>
+    void sincos_n(const T* in, T* sine, T* cosine, std::size_t n) {
+        std::size_t i = 0;
+        for (;i+batch_lanes<=n;i+=batch_lanes)
+            sincos_block<T>(in + i, sine + i, cosine + i);
+        if (i < n) {
+            T tail_in[batch_lanes], tail_sin[batch_lanes], tail_cos[batch_lanes];
+            for (unsigned j=0;j<batch_lanes;j++)
+                tail_in[j] = (i + j < n) ? in[i+j] : in[i];
+            sincos_block<T>(tail_in, tail_sin, tail_cos);
+            for (unsigned j=0;i+j<n;j++) {
+                sine[i+j] = tail_sin[j];
+                cosine[i+j] = tail_cos[j];
+            }
+        }
+    }
+
+
+    template<typename T>
+    void sin_n(const T* in, T* out, std::size_t n) {
+        for_each_block<T>(in, out, n, [](const T* x, T* y) {T c[batch_lanes]; sincos_block<T>(x, y, c);});
+    }
+
+
+    template<typename T>
+    void cos_n(const T* in, T* out, std::size_t n) {
+        for_each_block<T>(in, out, n, [](const T* x, T* y) {T s[batch_lanes]; sincos_block<T>(x, s, y);});
+    }
+
+
+    template<typename T>
+    void exp_n(const T* in, T* out, std::size_t n) {
+        for_each_block<T>(in, out, n, exp_block<T>);
+    }
+
+
+    template<typename T>
+    void ln_n(const T* in, T* out, std::size_t n) {
+        for_each_block<T>(in, out, n, ln_block<T>);
+    }
+
+
+    template<typename T>
+    void log_n(const T* in, T* out, std::size_t n) {
+        ln_n<T>(in, out, n);
+    }
+
+
+    template<typename T>
+    void sqrt_n(const T* in, T* out, std::size_t n) {
+        for_each_block<T>(in, out, n, sqrt_block<T>);
+    }
+
+
+    template<typename T>
+    void asin_n(const T* in, T* out, std::size_t n) {
+        for_each_block<T>(in, out, n, asin_block<T>);
+    }
+
+
+
+    // --- constant latency functions ---
+    // Single lane versions of the batch kernels - no early exits, no recursion and no loops depending on the argument.
+    // Defining TAYLOR_CONSTANT_LATENCY makes all default functions use them.
+    // The constant tables are created by the first call of each function.
+
+    namespace constant_latency {
+
+        template<typename T, unsigned bits>
+        std::pair<T, T> sincos(T x) {
+            MATH_STATS_SCOPE("taylor::constant_latency::sincos", T)
+            T s, c;
+            sincos_block<T, 1, bits>(&x, &s, &c);
+            return std::make_pair(s, c);
+        }
+
+
+        template<typename T, unsigned bits>
+        T sin(T x) {
+            MATH_STATS_SCOPE("taylor::constant_latency::sin", T)
+            return sincos<T, bits>(x).first;
+        }
+
+
+        template<typename T, unsigned bits>
+        T cos(T x) {
+            MATH_STATS_SCOPE("taylor::constant_latency::cos", T)
+            return sincos<T, bits>(x).second;
+        }
+
+
+        template<typename T, unsigned bits>
+        T sqrt(T x) {
+            MATH_STATS_SCOPE("taylor::constant_latency::sqrt", T)
+            T result;
+            sqrt_block<T, 1, bits>(&x, &result);
+            return result;
+        }
+
+
+        template<typename T, unsigned bits>
+        T asin(T x) {
+            MATH_STATS_SCOPE("taylor::constant_latency::asin", T)
+            T result;
+            asin_block<T, 1, bits>(&x, &result);
+            return result;
+        }
+
+
+        template<typename T, unsigned bits>
+        T ln(T x) {
+            MATH_STATS_SCOPE("taylor::constant_latency::ln", T)
+            T result;
+            ln_block<T, 1, bits>(&x, &result);
+            return result;
+        }
+
+
+        template<typename T, unsigned bits>
+        T log(T x) {
+            MATH_STATS_SCOPE("taylor::constant_latency::log", T)
+            return ln<T, bits>(x);
+        }
+
+
+        template<typename T, unsigned bits>
+        T exp(T x) {
+            MATH_STATS_SCOPE("taylor::constant_latency::exp", T)
+            T result;
+            exp_block<T, 1, bits>(&x, &result);
+            return result;
+        }
+
+
+        // near |x| = 1 from the series of asin(sqrt((1-|x|)/2)) - no cancellation with pi/2
+        template<typename T, unsigned bits>
+        T acos(T x) {
+            MATH_STATS_SCOPE("taylor::constant_latency::acos", T)
+            constexpr static const T pi = M_PI;
+            constexpr static const T pi2 = M_PI / 2;
+            constexpr static const T half = 0.5;
+            bool neg = x < 0;
+            T y = neg ? -x : x;
+            bool big = y > half;
+            T t = div_by_pow2<T>(1 - y, 1);
+            sqrt_block<T, 1, bits>(&t, &t);
+            T u = big ? t : y;
+            T a;
+            asin_block<T, 1, bits>(&u, &a);
+            T result = big ? mul_by_pow2<T>(a, 1) : pi2 - a;
+            return neg ? pi - result : result;
+        }
+
+
+        template<typename T, unsigned bits>
+        T tan(T x) {
+            MATH_STATS_SCOPE("taylor::constant_latency::tan", T)
+            std::pair<T, T> sc = sincos<T, bits>(x);
+            return sc.first / sc.second;
+        }
+
+
+        template<typename T, unsigned bits>
+        T atan(T x) {
+            MATH_STATS_SCOPE("taylor::constant_latency::atan", T)
+            bool neg = x < 0;
+            T y = neg ? -x : x;
+            T one = 1;
+            T result;
+            atan_frac_block<T, 1, bits>(&y, &one, &result);
+            return neg ? -result : result;
+        }
+
+
+        template<typename T, unsigned bits>
+        T atan2(T y, T x) {
+            MATH_STATS_SCOPE("taylor::constant_latency::atan2", T)
+            constexpr static const T pi = M_PI;
+            T ax = (x < 0) ? -x : x;
+            T ay = (y < 0) ? -y : y;
+            T result;
+            atan_frac_block<T, 1, bits>(&ay, &ax, &result);
+            result = (x < 0) ? pi - result : result;
+            return (y < 0) ? -result : result;
+        }
+
+
+        // up to |x| = 1 from the odd series - (e^x - e^-x) / 2 cancels for small |x|
+        template<typename T, unsigned bits>
+        T sinh(T x) {
+            MATH_STATS_SCOPE("taylor::constant_latency::sinh", T)
+            constexpr14 static const unsigned terms = bounded_terms((factorial_series_terms(1, target_bits<T, bits>()) + 1) / 2);
+            const batch_tables<T>& tab = batch_tables<T>::get();
+            bool neg = x < 0;
+            T y = neg ? -x : x;
+            bool small = y <= 1;
+            T u = small ? y : T(1);
+            T u2 = u * u;
+            T s = tab.sin_coefficients[terms-1];
+            for (unsigned i=terms-1;i-->0;)
+                s = tab.sin_coefficients[i] + u2 * s;
+            T e;
+            exp_block<T, 1, bits>(&y, &e);
+            T result = small ? u * s : div_by_pow2<T>(e - 1 / e, 1);
+            return neg ? -result : result;
+        }
+
+
+        template<typename T, unsigned bits>
+        T cosh(T x) {
+            MATH_STATS_SCOPE("taylor::constant_latency::cosh", T)
+            T y = (x < 0) ? -x : x;
+            T e;
+            exp_block<T, 1, bits>(&y, &e);
+            return div_by_pow2<T>(e + 1 / e, 1);
+        }
+
+
+        // tanh(x) = (1 - q) / (1 + q), q = e^-2|x| - the argument is limited to the saturation of the type, so -2|x| fits in it
+        template<typename T, unsigned bits>
+        T tanh(T x) {
+            MATH_STATS_SCOPE("taylor::constant_latency::tanh", T)
+            constexpr14 static const T saturation = (target_bits<T, bits>() + 1) * M_LN2 / 2;
+            bool neg = x < 0;
+            T y = neg ? -x : x;
+            y = (y < saturation) ? y : saturation;
+            T m = -mul_by_pow2<T>(y, 1);
+            T q;
+            exp_block<T, 1, bits>(&m, &q);
+            T result = (1 - q) / (1 + q);
+            return neg ? -result : result;
+        }
+
     }
 
 
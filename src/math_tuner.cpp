@@ -0,0 +1,167 @@
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <cmath>
+#include <string>
+#include <vector>
+#include <functional>
+#include <type_traits>
+
+#include "lib/fixedpoint.h"
+#include "lib/taylormath.h"
+#include "lib/polyapprox.h"
+#include "lib/polyapprox_sizing.h"
+#include "lib/polyapprox_codegen.h"
+#include "lib/mathdispatch.h"
+#include "lib/mathsweep.h"
+#include "mathdispatch_sites.h"
+
+// Benchmarks std, taylor and PolyApprox in float, double, fixed32_s, fixed32_a and fixed64 for every site of mathdispatch_sites.h
+// and writes the header of choices - the fastest candidate which meets the error, the most accurate one if none does:
+// math_tuner [header] (default src/mathdispatch_choices.h)
+
+
+const unsigned samples = 4096;
+const unsigned repeats = 7;
+const unsigned max_part_count = 1024;
+
+
+struct candidate {
+    std::string description;
+    double max_error;
+    double ns_per_call;
+    // writes the table (if any) and the specialization of math_dispatch::choice
+    std::function<void(std::ostream&)> emit;
+};
+
+
+template<typename Site>
+double max_error(const std::vector<typename Site::type>& args, const std::function<typename Site::type(typename Site::type)>& fun) {
+    double error = 0;
+    for (const auto& x : args) {
+        const double e = std::abs((double)fun(x) - Site::function::reference((double)x));
+        error = (e <= error) ? error : e;
+    }
+    return error;
+}
+
+template<typename Site>
+candidate measure(const std::string& description, const std::vector<typename Site::type>& args, const std::function<typename Site::type(typename Site::type)>& fun,
+                  std::function<void(std::ostream&)> emit) {
+    fun(args[0]);
+    return {description, max_error<Site>(args, fun), math_sweep::ns_per_call<typename Site::type>(args, fun, repeats), emit};
+}
+
+template<typename Site>
+void emit_selected(std::ostream& out, const std::string& impl, const std::string& type_name) {
+    out << "    template<> struct choice<::" << Site::name() << "> : selected<implementation::" << impl << ", " << type_name << "> {};\n";
+}
+
+
+template<typename Site, typename C>
+typename std::enable_if<std::is_floating_point<C>::value, void>::type add_std(std::vector<candidate>& list, const std::string& type_name,
+                                                                               const std::vector<typename Site::type>& args) {
+    using T = typename Site::type;
+    list.push_back(measure<Site>("std " + type_name, args, [](T x) {return math_dispatch::dispatcher<Site, math_dispatch::selected<math_dispatch::implementation::std_math, C>>::call(x);},
+                                 [type_name](std::ostream& out) {emit_selected<Site>(out, "std_math", type_name);}));
+}
+
+template<typename Site, typename C>
+typename std::enable_if<!std::is_floating_point<C>::value, void>::type add_std(std::vector<candidate>&, const std::string&, const std::vector<typename Site::type>&) {
+}
+
+template<typename Site, typename C>
+void add_candidates(std::vector<candidate>& list, const std::string& type_name, const std::vector<typename Site::type>& args) {
+    using T = typename Site::type;
+    add_std<Site, C>(list, type_name, args);
+
+    list.push_back(measure<Site>("taylor " + type_name, args, [](T x) {return math_dispatch::dispatcher<Site, math_dispatch::selected<math_dispatch::implementation::taylor, C>>::call(x);},
+                                 [type_name](std::ostream& out) {emit_selected<Site>(out, "taylor", type_name);}));
+
+    // half of the error for the table, the rest for the conversions
+    polyapprox_sizing::target goal;
+    goal.max_error = Site::max_error() / 2;
+    const auto sized = polyapprox_sizing::build<C, double>(std::function<double(double)>(Site::function::reference), Site::min(), Site::max(), goal, 1e-3, max_part_count);
+    const PolyApprox<C> approx = sized.approx;
+    const unsigned parts = approx.getPartCount();
+    list.push_back(measure<Site>("approx " + type_name + " " + std::to_string(parts) + " parts", args, [approx](T x) {return T(approx(C(x)));},
+                                 [approx, type_name, parts](std::ostream& out) {
+        const std::string table_type = "PolyApprox<" + type_name + ", " + std::to_string(parts) + ">";
+        out << "    namespace tables {\n";
+        polyapprox_codegen::writeTable(out, approx, Site::name(), type_name, "        ");
+        out << "    }\n";
+        out << "    template<> struct choice<::" << Site::name() << "> : selected<implementation::approx, " << type_name << "> {\n";
+        out << "        static constexpr const " << table_type << "& table() {return tables::" << Site::name() << ";}\n";
+        out << "    };\n";
+    }));
+}
+
+
+template<typename Site>
+void tune(std::ostream& header) {
+    math_sweep::config cfg;
+    cfg.samples = samples;
+    // arguments rounded out of the range are not the site's
+    std::vector<typename Site::type> args;
+    for (const auto& x : math_sweep::arguments<typename Site::type>(Site::min(), Site::max(), cfg))
+        if ((double)x >= Site::min() && (double)x <= Site::max())
+            args.push_back(x);
+
+    std::vector<candidate> list;
+    add_candidates<Site, float>(list, "float", args);
+    add_candidates<Site, double>(list, "double", args);
+    add_candidates<Site, fixed32_s>(list, "fixed32_s", args);
+    add_candidates<Site, fixed32_a>(list, "fixed32_a", args);
+    add_candidates<Site, fixed64>(list, "fixed64", args);
+
+    const candidate* best = nullptr;
+    for (const auto& c : list) {
+        const bool met = c.max_error <= Site::max_error();
+        const bool best_met = best && best->max_error <= Site::max_error();
+        if (!best || (met && (!best_met || c.ns_per_call < best->ns_per_call)) || (!met && !best_met && c.max_error < best->max_error))
+            best = &c;
+    }
+
+    std::cout << Site::name() << " (" << Site::function::name() << ", " << Site::type_name() << ", [" << Site::min() << ", " << Site::max()
+              << "], error " << Site::max_error() << ")" << std::endl;
+    for (const auto& c : list)
+        std::cout << (&c == best ? "  * " : "    ") << std::left << std::setw(32) << c.description << std::right
+                  << std::setw(14) << c.max_error << std::setw(10) << std::fixed << std::setprecision(2) << c.ns_per_call << " ns"
+                  << std::defaultfloat << std::setprecision(6) << std::endl;
+
+    header << "    // " << Site::name() << ": " << best->description << ", error " << best->max_error << ", " << best->ns_per_call << " ns"
+           << (best->max_error <= Site::max_error() ? "" : " - the target is not met") << "\n";
+    best->emit(header);
+    header << "\n";
+}
+
+
+int main(int argc, char** argv) {
+
+    const std::string fileName = (argc > 1) ? argv[1] : "src/mathdispatch_choices.h";
+
+    std::ostringstream header;
+    header << "// generated by math_tuner - python3 builder.py release tune\n\n";
+    header << "#ifndef MATH_DISPATCH_CHOICES_H\n#define MATH_DISPATCH_CHOICES_H\n\n";
+    header << "#include \"mathdispatch_sites.h\"\n\n";
+    header << "namespace math_dispatch {\n\n";
+
+    #define MATH_TUNE_SITE(site, fun, T, range_min, range_max, error) tune<site>(header);
+    MATH_DISPATCH_SITES(MATH_TUNE_SITE)
+    #undef MATH_TUNE_SITE
+
+    header << "}\n\n#endif\n";
+
+    std::ofstream file(fileName);
+    file << header.str();
+    if (!file) {
+        std::cerr << "Cannot write " << fileName << std::endl;
+        return 1;
+    }
+    std::cout << "Choices saved to " << fileName << std::endl;
+
+    return 0;
+}
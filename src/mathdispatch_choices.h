@@ -0,0 +1,10 @@
+// generated by math_tuner - python3 builder.py release tune
+
+#ifndef MATH_DISPATCH_CHOICES_H
+#define MATH_DISPATCH_CHOICES_H
+
+#include "mathdispatch_sites.h"
+
+// not tuned - taylormath of the argument types
+
+#endif
@@ -0,0 +1,15 @@
+#ifndef MATH_DISPATCH_SITES_H
+#define MATH_DISPATCH_SITES_H
+
+#include "lib/mathdispatch.h"
+
+// Call sites tuned by math_tuner: name, function, argument type, range and the allowed absolute error.
+#define MATH_DISPATCH_SITES(SITE) \
+    SITE(control_sin, sin, float, -3.1416, 3.1416, 1e-5) \
+    SITE(sensor_log, log, float, 0.01, 10, 1e-4) \
+    SITE(filter_exp, exp, fixed32_a, -4, 4, 1e-2) \
+    SITE(gain_sqrt, sqrt, fixed64, 0, 16, 1e-4)
+
+MATH_DISPATCH_SITES(MATH_DISPATCH_SITE)
+
+#endif
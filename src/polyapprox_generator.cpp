@@ -0,0 +1,74 @@
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <cmath>
+#include <string>
+#include <functional>
+
+#include "lib/fixedpoint.h"
+#include "lib/polyapprox.h"
+#include "lib/polyapprox_codegen.h"
+
+// Fits PolyApprox offline and prints a header with a constexpr table:
+// polyapprox_generator <function> <type> <part count> <range min> <range max> [name] > table.h
+
+
+std::function<double(double)> source_function(const std::string& name) {
+    if (name == "sin") return [](double x) {return std::sin(x);};
+    if (name == "cos") return [](double x) {return std::cos(x);};
+    if (name == "tan") return [](double x) {return std::tan(x);};
+    if (name == "asin") return [](double x) {return std::asin(x);};
+    if (name == "acos") return [](double x) {return std::acos(x);};
+    if (name == "atan") return [](double x) {return std::atan(x);};
+    if (name == "sinh") return [](double x) {return std::sinh(x);};
+    if (name == "cosh") return [](double x) {return std::cosh(x);};
+    if (name == "tanh") return [](double x) {return std::tanh(x);};
+    if (name == "exp") return [](double x) {return std::exp(x);};
+    if (name == "log") return [](double x) {return std::log(x);};
+    if (name == "sqrt") return [](double x) {return std::sqrt(x);};
+    return nullptr;
+}
+
+
+template<typename T>
+void generate(const std::string& type_name, const std::function<double(double)>& src, unsigned part_count, double range_min, double range_max, const std::string& name) {
+    PolyApprox<T> approx = PolyApprox<T>::template create<double>(src, part_count, range_min, range_max);
+    polyapprox_codegen::toHeader(std::cout, approx, name, type_name);
+}
+
+
+int main(int argc, char** argv) {
+
+    if (argc < 6) {
+        std::cerr << "usage: " << argv[0] << " <function> <type> <part count> <range min> <range max> [name]" << std::endl;
+        std::cerr << "functions: sin cos tan asin acos atan sinh cosh tanh exp log sqrt" << std::endl;
+        std::cerr << "types: fixed32 fixed32_a fixed32_s fixed64 float double" << std::endl;
+        return 1;
+    }
+
+    const std::string function = argv[1];
+    const std::string type = argv[2];
+    const unsigned part_count = std::atoi(argv[3]);
+    const double range_min = std::atof(argv[4]);
+    const double range_max = std::atof(argv[5]);
+    const std::string name = (argc > 6) ? argv[6] : function + "_table";
+
+    const std::function<double(double)> src = source_function(function);
+    if (!src || part_count == 0) {
+        std::cerr << "unknown function or wrong part count" << std::endl;
+        return 1;
+    }
+
+    if (type == "fixed32") generate<fixed32>(type, src, part_count, range_min, range_max, name);
+    else if (type == "fixed32_a") generate<fixed32_a>(type, src, part_count, range_min, range_max, name);
+    else if (type == "fixed32_s") generate<fixed32_s>(type, src, part_count, range_min, range_max, name);
+    else if (type == "fixed64") generate<fixed64>(type, src, part_count, range_min, range_max, name);
+    else if (type == "float") generate<float>(type, src, part_count, range_min, range_max, name);
+    else if (type == "double") generate<double>(type, src, part_count, range_min, range_max, name);
+    else {
+        std::cerr << "unknown type " << type << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
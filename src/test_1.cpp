@@ -33,6 +33,17 @@ void test() {
         }
     }
 
+    for (float x=-10;x<10;x+=2.5e-2) {
+        test_no++;
+        std::pair<FP, FP> sc = taylor::sincos<FP>(FP(x));
+        float a = (float)sc.first;
+        float b = (float)sc.second;
+        if (std::abs(a - std::sin(x)) > 2e-3 || std::abs(b - std::cos(x)) > 2e-3) {
+            std::cout << "Error at test " << test_no << " (sincos) at x = " << x << " : " << " expected: " << std::sin(x) << ", " << std::cos(x) << " got: " << a << ", " << b << std::endl;
+            status_code = 1;
+        }
+    }
+
     for (float x=0;x<20;x+=1e-2) {
         test_no++;
         float a = (float)taylor::sqrt<FP>(FP(x));
@@ -72,6 +83,137 @@ void test() {
             status_code = 1;
         }
     }
+
+    for (float x=-0.999;x<0.999;x+=1e-2) {
+        test_no++;
+        float a = (float)taylor::acos<FP>(FP(x));
+        float b = std::acos(x);
+        if (std::abs(a - b) > 0.01) {
+            std::cout << "Error at test " << test_no << " (acos) at x = " << x << " : " << " expected: " << b << " got: " << a << std::endl;
+            status_code = 1;
+        }
+    }
+
+    for (float x=-1.5;x<1.5;x+=1e-2) {
+        test_no++;
+        float a = (float)taylor::tan<FP>(FP(x));
+        float b = std::tan(x);
+        if (std::abs(a - b) > 2e-3 * (1 + b*b)) {
+            std::cout << "Error at test " << test_no << " (tan) at x = " << x << " : " << " expected: " << b << " got: " << a << std::endl;
+            status_code = 1;
+        }
+    }
+
+    for (float x=-50;x<50;x+=0.1) {
+        test_no++;
+        float a = (float)taylor::atan<FP>(FP(x));
+        float b = std::atan(x);
+        if (std::abs(a - b) > 2e-3) {
+            std::cout << "Error at test " << test_no << " (atan) at x = " << x << " : " << " expected: " << b << " got: " << a << std::endl;
+            status_code = 1;
+        }
+    }
+
+    for (float angle=-3.14;angle<3.14;angle+=2.5e-2) {
+        test_no++;
+        float x = 3 * std::cos(angle);
+        float y = 3 * std::sin(angle);
+        float a = (float)taylor::atan2<FP>(FP(y), FP(x));
+        float b = std::atan2(y, x);
+        if (std::abs(a - b) > 2e-3) {
+            std::cout << "Error at test " << test_no << " (atan2) at x = " << x << ", y = " << y << " : " << " expected: " << b << " got: " << a << std::endl;
+            status_code = 1;
+        }
+    }
+
+    for (float x=-5;x<5;x+=2.5e-2) {
+        test_no++;
+        float a = (float)taylor::sinh<FP>(FP(x));
+        float b = std::sinh(x);
+        float c = (float)taylor::cosh<FP>(FP(x));
+        float d = std::cosh(x);
+        if (std::abs(a - b) > 2e-3 * d || std::abs(c - d) > 2e-3 * d) {
+            std::cout << "Error at test " << test_no << " (sinh, cosh) at x = " << x << " : " << " expected: " << b << ", " << d << " got: " << a << ", " << c << std::endl;
+            status_code = 1;
+        }
+    }
+
+    for (float x=-10;x<10;x+=2.5e-2) {
+        test_no++;
+        float a = (float)taylor::tanh<FP>(FP(x));
+        float b = std::tanh(x);
+        if (std::abs(a - b) > 2e-3) {
+            std::cout << "Error at test " << test_no << " (tanh) at x = " << x << " : " << " expected: " << b << " got: " << a << std::endl;
+            status_code = 1;
+        }
+    }
+}
+
+
+template<typename FP, unsigned bits>
+void test_precision() {
+    // truncation error of the series is about 2^-bits (ln is more sensitive - see Readme)
+    const float epsilon = 4.f / (1 << bits);
+
+    for (float x=-10;x<10;x+=2.5e-2) {
+        test_no++;
+        float a = (float)taylor::sin<FP, bits>(FP(x));
+        float b = (float)taylor::sin<FP>(FP(x));
+        if (std::abs(a - b) > epsilon) {
+            std::cout << "Error at test " << test_no << " (sin, " << bits << " bits) at x = " << x << " : " << " expected: " << b << " got: " << a << std::endl;
+            status_code = 1;
+        }
+    }
+
+    for (float x=-0.999;x<0.999;x+=1e-2) {
+        test_no++;
+        float a = (float)taylor::asin<FP, bits>(FP(x));
+        float b = (float)taylor::asin<FP>(FP(x));
+        if (std::abs(a - b) > epsilon) {
+            std::cout << "Error at test " << test_no << " (asin, " << bits << " bits) at x = " << x << " : " << " expected: " << b << " got: " << a << std::endl;
+            status_code = 1;
+        }
+    }
+
+    for (float x=0.25;x<1.5;x+=1e-2) {
+        test_no++;
+        float a = (float)taylor::log<FP, bits>(FP(x));
+        float b = (float)taylor::log<FP>(FP(x));
+        if (std::abs(a - b) > 2 * epsilon) {
+            std::cout << "Error at test " << test_no << " (ln, " << bits << " bits) at x = " << x << " : " << " expected: " << b << " got: " << a << std::endl;
+            status_code = 1;
+        }
+    }
+
+    for (float x=-4;x<4;x+=2.5e-2) {
+        test_no++;
+        float a = (float)taylor::exp<FP, bits>(FP(x));
+        float b = (float)taylor::exp<FP>(FP(x));
+        if (std::abs(a - b) > epsilon * b) {
+            std::cout << "Error at test " << test_no << " (exp, " << bits << " bits) at x = " << x << " : " << " expected: " << b << " got: " << a << std::endl;
+            status_code = 1;
+        }
+    }
+
+    for (float x=-10;x<10;x+=2.5e-2) {
+        test_no++;
+        float a = (float)taylor::atan<FP, bits>(FP(x));
+        float b = (float)taylor::atan<FP>(FP(x));
+        if (std::abs(a - b) > epsilon) {
+            std::cout << "Error at test " << test_no << " (atan, " << bits << " bits) at x = " << x << " : " << " expected: " << b << " got: " << a << std::endl;
+            status_code = 1;
+        }
+    }
+
+    for (float x=-4;x<4;x+=2.5e-2) {
+        test_no++;
+        float a = (float)taylor::tanh<FP, bits>(FP(x));
+        float b = (float)taylor::tanh<FP>(FP(x));
+        if (std::abs(a - b) > epsilon) {
+            std::cout << "Error at test " << test_no << " (tanh, " << bits << " bits) at x = " << x << " : " << " expected: " << b << " got: " << a << std::endl;
+            status_code = 1;
+        }
+    }
 }
 
 
@@ -79,6 +221,11 @@ int main() {
 
     test<fixed32_a>();
     test<fixed64>();
+    test<double>();
+
+    test_precision<fixed64, 12>();
+    test_precision<double, 12>();
+    test_precision<double, 20>();
 
     return status_code;
 }
@@ -0,0 +1,80 @@
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <cmath>
+#include <functional>
+
+#include "lib/fixedpoint.h"
+#include "lib/polyapprox.h"
+#include "lib/polyapprox_parallel.h"
+
+
+int status_code = 0;
+unsigned long long test_no = 0;
+
+
+template<typename FP, typename A, typename B>
+void compare(const char* name, const A& serial, const B& parallel) {
+    for (double x=-3.2;x<3.2;x+=1e-3) {
+        test_no++;
+        if (serial(FP(x)) != parallel(FP(x))) {
+            std::cout << "Error at test " << test_no << " (" << name << ") at x = " << x << " : " << " expected: " << (double)serial(FP(x)) << " got: " << (double)parallel(FP(x)) << std::endl;
+            status_code = 1;
+            return;
+        }
+    }
+}
+
+
+template<typename FP>
+void test_fit() {
+    // the same coefficients as the serial fit
+    auto serial = PolyApprox<FP>::template create<double>(sin, 1000, -3, 3);
+    auto parallel = polyapprox_parallel::create<FP, 0, double>(sin, 1000, -3, 3, 1e-3, 4);
+    compare<FP>("parallel fit", serial, parallel);
+
+    auto static_serial = PolyApprox<FP, 64>::template create<double>(exp, -3, 3);
+    auto static_parallel = polyapprox_parallel::create<FP, 64, double>(exp, 0, -3, 3, 1e-3, 3);
+    compare<FP>("parallel static fit", static_serial, static_parallel);
+}
+
+
+void test_verify() {
+    auto approx = PolyApprox<fixed32>::create<double>(sin, 64, -1, 1);
+    std::function<double(double)> reference = [](double x) {return std::sin(x);};
+    auto report = polyapprox_parallel::verify<fixed32>(approx, reference, fixed32(-1), fixed32(1), 8, 4);
+    auto single = polyapprox_parallel::verify<fixed32>(approx, reference, fixed32(-1), fixed32(1), 8, 1);
+
+    test_no++;
+    std::uint64_t histogram_count = 0;
+    for (auto c: report.ulp_histogram)
+        histogram_count += c;
+    if (report.count != 65537 || histogram_count != report.count) {
+        std::cout << "Error at test " << test_no << " (verify count) " << report.count << ", " << histogram_count << std::endl;
+        status_code = 1;
+    }
+
+    test_no++;
+    if (report.max_error != single.max_error || report.max_error_x != single.max_error_x || report.ulp_histogram != single.ulp_histogram ||
+        std::abs(report.mean_error - single.mean_error) > 1e-12) {
+        std::cout << "Error at test " << test_no << " (verify threads) " << report.max_error << ", " << single.max_error << std::endl;
+        status_code = 1;
+    }
+
+    test_no++;
+    if (report.max_error > 1e-3 || report.mean_error > report.max_error ||
+        std::abs((double)approx(fixed32(report.max_error_x)) - std::sin(report.max_error_x)) != report.max_error) {
+        std::cout << "Error at test " << test_no << " (verify max) " << report.max_error << " at " << report.max_error_x << std::endl;
+        status_code = 1;
+    }
+}
+
+
+int main() {
+
+    test_fit<fixed32_a>();
+    test_fit<double>();
+    test_verify();
+
+    return status_code;
+}
@@ -0,0 +1,103 @@
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <cmath>
+
+#include "lib/fixedpoint.h"
+#include "lib/polyapprox.h"
+#include "lib/polyapprox_io.h"
+
+
+template<typename T, typename A, typename B>
+int compare(const A& a, const B& b) {
+    for (double x=-1;x<1;x+=1e-3)
+        if (a(T(x)) != b(T(x))) {
+            std::cout << "Error at test " << x << std::endl;
+            return 1;
+        }
+    return 0;
+}
+
+
+template<typename T>
+int round_trip() {
+    PolyApprox<T> fitted = PolyApprox<T>::template create<double>(sin, 64, -1, 1);
+    std::stringstream stream;
+    if (!polyapprox_io::save(stream, fitted))
+        return 1;
+    const std::string bytes = stream.str();
+
+    PolyApprox<T> loaded;
+    std::istringstream in(bytes);
+    if (!polyapprox_io::load(in, loaded) || loaded.getPartCount() != 64 || compare<T>(fitted, loaded))
+        return 2;
+
+    PolyApprox<T, 64> loaded_static;
+    std::istringstream in_static(bytes);
+    if (!polyapprox_io::load(in_static, loaded_static) || compare<T>(fitted, loaded_static))
+        return 3;
+
+    // the static part count must match
+    PolyApprox<T, 32> wrong_count;
+    std::istringstream in_wrong(bytes);
+    if (polyapprox_io::load(in_wrong, wrong_count))
+        return 4;
+
+    // truncated data is rejected
+    std::istringstream in_short(bytes.substr(0, bytes.size() - 1));
+    if (polyapprox_io::load(in_short, loaded) || !PolyApproxView<T>::fromBytes(bytes.data(), bytes.size() - 1).empty())
+        return 5;
+
+    if (compare<T>(fitted, PolyApproxView<T>(fitted)))
+        return 6;
+
+    std::string name = "polyapprox_test_11_" + std::to_string(sizeof(T)) + ".bin";
+    if (!polyapprox_io::save(name.c_str(), fitted))
+        return 7;
+#ifdef POLYAPPROX_MMAP
+    MappedPolyApprox<T> mapped(name.c_str());
+    if (!mapped.isOpen() || compare<T>(fitted, mapped))
+        return 8;
+    MappedPolyApprox<T> moved = std::move(mapped);
+    if (mapped.isOpen() || compare<T>(fitted, moved))
+        return 9;
+#endif
+    std::remove(name.c_str());
+    return 0;
+}
+
+
+int main() {
+
+    int result = round_trip<fixed32>();
+    if (result) return result;
+    result = round_trip<float>();
+    if (result) return 10 + result;
+    result = round_trip<double>();
+    if (result) return 20 + result;
+
+    // tables of other storable types are rejected
+    std::stringstream stream;
+    polyapprox_io::save(stream, PolyApprox<float>::create<double>(exp, 8, -1, 1));
+    PolyApprox<double> other;
+    if (polyapprox_io::load(stream, other))
+        return 31;
+
+    // fixed32 and fixed32_a have the same layout
+    std::stringstream fixed_stream;
+    polyapprox_io::save(fixed_stream, PolyApprox<fixed32>::create<double>(exp, 8, -1, 1));
+    PolyApprox<fixed32_a> fixed_a;
+    PolyApprox<fixed64> fixed_64;
+    std::istringstream fixed_in(fixed_stream.str());
+    if (!polyapprox_io::load(fixed_stream, fixed_a) || polyapprox_io::load(fixed_in, fixed_64))
+        return 32;
+
+    // an approximation without parts is not saved
+    std::stringstream empty_stream;
+    if (polyapprox_io::save(empty_stream, PolyApprox<float>()) || !empty_stream.str().empty() || !PolyApproxView<float>(PolyApprox<float>()).empty())
+        return 33;
+
+    return 0;
+}
@@ -0,0 +1,60 @@
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+#include <cmath>
+
+#include "lib/fixedpoint.h"
+#include "lib/polyapprox.h"
+#include "lib/polyapprox_registry.h"
+
+
+int main() {
+
+    auto& registry = PolyApproxRegistry<fixed32>::instance();
+    if (&registry != &PolyApproxRegistry<fixed32>::instance() || registry.size() != 0)
+        return 1;
+
+    auto sin_table = registry.get("sin", sin, 64, -1, 1);
+    if (!sin_table || registry.get("sin", sin, 64, -1, 1) != sin_table || registry.find("sin", 64, -1, 1) != sin_table)
+        return 2;
+
+    // another part count, range, dx or storable type is another table
+    if (registry.get("sin", sin, 32, -1, 1) == sin_table || registry.get("sin", sin, 64, -2, 2) == sin_table
+            || registry.get("sin", sin, 64, -1, 1, 1e-2) == sin_table || registry.size() != 4)
+        return 3;
+    if (PolyApproxRegistry<float>::instance().size() != 0)
+        return 4;
+
+    PolyApprox<fixed32> direct = PolyApprox<fixed32>::create<double>(sin, 64, -1, 1);
+    for (double x=-1;x<1;x+=1e-3)
+        if ((*sin_table)(fixed32(x)) != direct(fixed32(x))) {
+            std::cout << "Error at test " << x << std::endl;
+            return 5;
+        }
+
+    // concurrent requests of a missing table get the same instance
+    std::vector<std::shared_ptr<const PolyApprox<fixed32>>> results(8);
+    std::vector<std::thread> threads;
+    for (unsigned t=0;t<results.size();t++)
+        threads.emplace_back([&results, &registry, t]() {results[t] = registry.get("exp", exp, 128, -1, 1);});
+    for (auto& thread: threads)
+        thread.join();
+    for (auto& result: results)
+        if (!result || result != results[0])
+            return 6;
+
+    registry.populate({{"cos", cos, 64, -1, 1, 1e-3}, {"log", log, 64, 0.1, 10, 1e-3}, {"cos", cos, 64, -1, 1, 1e-3}}, 3);
+    if (registry.size() != 7 || !registry.find("log", 64, 0.1, 10))
+        return 7;
+
+    registry.seal();
+    if (!registry.isSealed() || registry.get("sqrt", sqrt, 64, 0, 1) || registry.get("cos", cos, 64, -1, 1) != registry.find("cos", 64, -1, 1))
+        return 8;
+    if (registry.size() != 7)
+        return 9;
+
+    return 0;
+}
@@ -0,0 +1,69 @@
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <cmath>
+
+#include "lib/fixedpoint.h"
+#include "lib/polyapprox.h"
+#include "lib/polyapprox_compact.h"
+
+
+template<typename Fixed, typename Coef>
+int test(double (*fun)(double), unsigned part_count, double range_min, double range_max, unsigned extra_ulps=4) {
+    CompactPolyApprox<Fixed, Coef> compact = CompactPolyApprox<Fixed, Coef>::template create<double>(fun, part_count, range_min, range_max);
+    ShiftPolyApprox<Fixed> shift = ShiftPolyApprox<Fixed>::template create<double>(fun, part_count, range_min, range_max);
+    double compact_error = 0, shift_error = 0;
+    for (double x=range_min;x<=range_max;x+=1e-4) {
+        compact_error = std::max(compact_error, std::abs((double)compact(Fixed(x)) - fun(x)));
+        shift_error = std::max(shift_error, std::abs((double)shift(Fixed(x)) - fun(x)));
+    }
+    // narrow coefficients add a few units of the last place (more with int8_t)
+    const double ulp = (double)Fixed::buf_cast(1);
+    if (compact_error > shift_error + extra_ulps * ulp || compact.getPartCount() != shift.getPartCount() || compact.getWidthLog2() != shift.getWidthLog2()) {
+        std::cout << "Error at test " << part_count << ": parts " << compact.getPartCount() << " (" << compact.getTableBytes() << " bytes) error " << compact_error
+                  << ", ShiftPolyApprox error " << shift_error << std::endl;
+        return 1;
+    }
+    return 0;
+}
+
+
+int main() {
+
+    static_assert(sizeof(CompactPolyApprox<fixed32>::part) == 12, "4 byte value, 3 coefficients and an exponent");
+    static_assert(sizeof(CompactPolyApprox<fixed32, std::int8_t>::part) == 8, "4 byte value, 3 coefficients and an exponent");
+    static_assert(sizeof(IntPolyApprox<fixed32_s>::part) == 16, "3 coefficients in Horner and a 4 byte value");
+
+    if (test<fixed32, std::int16_t>(sin, 64, -3.14, 3.14)) return 1;
+    if (test<fixed32, std::int16_t>(exp, 256, -2, 2)) return 2;
+    if (test<fixed32, std::int8_t>(sin, 256, -3.14, 3.14, 16)) return 3;
+    if (test<fixed32_a, std::int16_t>(sqrt, 256, 0.25, 16)) return 4;
+    if (test<fixed64, std::int16_t>(sin, 1024, -3.14, 3.14)) return 5;
+    if (test<fixed64, std::int32_t>(sin, 1024, -3.14, 3.14)) return 6;
+
+    // integer Horner is at least as accurate as the fixed point multiplications
+    for (auto fun: {sin, exp}) {
+        PolyApprox<fixed32_s> poly = PolyApprox<fixed32_s>::create<double>(fun, 256, -2, 2);
+        IntPolyApprox<fixed32_s> integer = IntPolyApprox<fixed32_s>::create<double>(fun, 256, -2, 2);
+        PolyApprox<fixed64> poly64 = PolyApprox<fixed64>::create<double>(fun, 256, -2, 2);
+        IntPolyApprox<fixed64> integer64 = IntPolyApprox<fixed64>::create<double>(fun, 256, -2, 2);
+        if (!(integer.getMaxError<double>(fun, 1e-4) < poly.getMaxError<double>(fun, 1e-4)) ||
+            !(integer64.getMaxError<double>(fun, 1e-4) * 10 < poly64.getMaxError<double>(fun, 1e-4)))
+            return 8;
+        // Horner in the buffer type where the partial products fit
+        PolyApprox<fixed32> poly32 = PolyApprox<fixed32>::create<double>(fun, 256, -2, 2);
+        IntPolyApprox<fixed32, std::int32_t> integer32 = IntPolyApprox<fixed32, std::int32_t>::create<double>(fun, 256, -2, 2);
+        if (!(integer32.getMaxError<double>(fun, 1e-4) < poly32.getMaxError<double>(fun, 1e-4)))
+            return 9;
+    }
+
+    // clamped outside the range
+    CompactPolyApprox<fixed32> compact = CompactPolyApprox<fixed32>::create<double>(exp, 16, 0, 1);
+    if (compact(fixed32(-5)) != compact(fixed32(0)) || compact(fixed32(5)) != compact(fixed32(1)))
+        return 7;
+    IntPolyApprox<fixed32> integer = IntPolyApprox<fixed32>::create<double>(exp, 16, 0, 1);
+    if (integer(fixed32(-5)) != integer(fixed32(0)) || integer(fixed32(5)) != integer(fixed32(1)))
+        return 10;
+
+    return 0;
+}
@@ -0,0 +1,50 @@
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <cmath>
+
+#include "lib/fixedpoint.h"
+#include "lib/polyapprox.h"
+
+
+template<typename T, typename Approx>
+double max_error(const Approx& approx, double (*fun)(double), double range_min, double range_max) {
+    double result = 0;
+    for (double x=range_min;x<range_max;x+=(range_max-range_min)*1e-5)
+        result = std::max(result, std::abs((double)approx(T(x)) - fun(x)));
+    return result;
+}
+
+
+// minimax parts have the smallest error, Chebyshev parts are close to them, both are better than hermite parts
+template<typename T>
+int test_modes(double (*fun)(double), unsigned part_count, double range_min, double range_max, double ratio) {
+    double hermite = max_error<T>(PolyApprox<T>::template create<double>(fun, part_count, range_min, range_max), fun, range_min, range_max);
+    double chebyshev = max_error<T>(PolyApprox<T>::template create<double>(fun, part_count, range_min, range_max, 1e-3, PolyApproxFit::chebyshev), fun, range_min, range_max);
+    double minimax = max_error<T>(PolyApprox<T>::template create<double>(fun, part_count, range_min, range_max, 1e-3, PolyApproxFit::minimax), fun, range_min, range_max);
+    double shift_hermite = max_error<T>(ShiftPolyApprox<T>::template create<double>(fun, part_count, range_min, range_max), fun, range_min, range_max);
+    double shift_minimax = max_error<T>(ShiftPolyApprox<T>::template create<double>(fun, part_count, range_min, range_max, 1e-3, PolyApproxFit::minimax), fun, range_min, range_max);
+    if (!(minimax * ratio < hermite) || !(chebyshev * ratio < hermite) || !(minimax <= chebyshev * 1.01) || !(shift_minimax * ratio < shift_hermite)) {
+        std::cout << "Error at test " << part_count << ": hermite " << hermite << " chebyshev " << chebyshev << " minimax " << minimax
+                  << " (ShiftPolyApprox " << shift_hermite << " / " << shift_minimax << ")" << std::endl;
+        return 1;
+    }
+    return 0;
+}
+
+
+int main() {
+
+    if (test_modes<double>(sin, 16, -3.14, 3.14, 4)) return 1;
+    if (test_modes<double>(exp, 16, -2, 2, 4)) return 2;
+    if (test_modes<double>(log, 64, 0.1, 10, 2)) return 3;
+    if (test_modes<float>(sin, 16, -3.14, 3.14, 4)) return 4;
+
+    // fixed point types are limited by their resolution
+    double hermite = max_error<fixed32>(PolyApprox<fixed32>::create<double>(sin, 16, -3.14, 3.14), sin, -3.14, 3.14);
+    double minimax = max_error<fixed32>(PolyApprox<fixed32>::create<double>(sin, 16, -3.14, 3.14, 1e-3, PolyApproxFit::minimax), sin, -3.14, 3.14);
+    if (!(minimax < hermite))
+        return 5;
+
+    return 0;
+}
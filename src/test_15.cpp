@@ -0,0 +1,56 @@
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <cmath>
+
+#include "lib/fixedpoint.h"
+#include "lib/polyapprox.h"
+#include "lib/polyapprox_sizing.h"
+
+
+int error(int code, const polyapprox_sizing::report& info) {
+    std::cout << "Error at test " << code << ": met " << info.met << " parts " << info.part_count << " mode " << (int)info.mode << " error " << info.max_error
+              << " ulps " << info.max_ulps << " bytes " << info.bytes << " fits " << info.fits << std::endl;
+    return code;
+}
+
+
+int main() {
+
+    polyapprox_sizing::target goal;
+    goal.max_error = 1e-6;
+    auto sized = polyapprox_sizing::build<double, double>(sin, -3.14, 3.14, goal);
+    if (!sized.info.met || sized.info.max_error > 1e-6 || sized.approx.getPartCount() != sized.info.part_count)
+        return error(1, sized.info);
+    // one part less does not meet the target with the chosen mode
+    auto smaller = PolyApprox<double>::create<double>(sin, sized.info.part_count - 1, -3.14, 3.14, 1e-3, sized.info.mode);
+    polyapprox_sizing::report smaller_info;
+    polyapprox_sizing::measure_error<double>(smaller, polyapprox_sizing::error_grid<double>(std::function<double(double)>(sin), -3.14, 3.14, 8u << 16), smaller_info);
+    if (polyapprox_sizing::meets(smaller_info, goal))
+        return 2;
+    // hermite needs more parts than the chosen mode
+    auto hermite = PolyApprox<double>::create<double>(sin, sized.info.part_count, -3.14, 3.14);
+    if (!(hermite.getMaxError<double>(sin, 1e-4) > 1e-6))
+        return 3;
+
+    // the budget is not enough - the most accurate table within it
+    goal.max_bytes = 16 * sizeof(std::array<double, 5>);
+    auto limited = polyapprox_sizing::build<double, double>(sin, -3.14, 3.14, goal);
+    if (limited.info.met || limited.info.bytes > goal.max_bytes || limited.info.part_count != 16)
+        return error(4, limited.info);
+
+    polyapprox_sizing::target ulp_goal;
+    ulp_goal.max_ulps = 2;
+    auto fixed = polyapprox_sizing::build<fixed32, double>(exp, -1, 1, ulp_goal);
+    if (!fixed.info.met || fixed.info.max_ulps > 2 || fixed.info.bytes != fixed.info.part_count * 20)
+        return error(5, fixed.info);
+
+    // ulps of a function crossing zero - counted in the unit of the largest value, so the target is reachable
+    polyapprox_sizing::target sin_ulps;
+    sin_ulps.max_ulps = 16;
+    auto ulp_sized = polyapprox_sizing::build<double, double>(sin, -3.14, 3.14, sin_ulps);
+    if (!ulp_sized.info.met || ulp_sized.info.max_ulps > 16 || ulp_sized.info.part_count >= 1u << 14)
+        return error(6, ulp_sized.info);
+
+    return 0;
+}
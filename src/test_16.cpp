@@ -0,0 +1,67 @@
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <cmath>
+
+#include "lib/fixedpoint.h"
+#include "lib/polyapprox.h"
+#include "lib/polyapprox_fold.h"
+
+
+template<typename T, typename Approx>
+int check(const Approx& approx, double (*fun)(double), double range_min, double range_max, double max_error) {
+    double error = 0;
+    for (double x=range_min;x<=range_max;x+=1e-3) {
+        const double arg = (double)T(x);
+        error = std::max(error, std::abs((double)approx(T(x)) - fun(arg)));
+    }
+    if (error > max_error) {
+        std::cout << "Error at test " << error << std::endl;
+        return 1;
+    }
+    return 0;
+}
+
+
+double sin_quarter(double x) {
+    return std::sin(M_PI / 2 * x);
+}
+
+
+int main() {
+
+    const double pi = M_PI;
+
+    // a quarter of the period covers [-100, 100]
+    auto double_sin = FoldedPolyApprox<double>::create<double>(sin, 64, PolyApproxFold::sine(2 * pi), 0, 0, 1e-3, PolyApproxFit::chebyshev);
+    auto double_cos = FoldedPolyApprox<double>::create<double>(cos, 64, PolyApproxFold::cosine(2 * pi), 0, 0, 1e-3, PolyApproxFit::chebyshev);
+    if (double_sin.getApprox().getPartCount() != 64 || double_sin.isMaskFolded())
+        return 1;
+    if (check<double>(double_sin, sin, -100, 100, 1e-8) || check<double>(double_cos, cos, -100, 100, 1e-8))
+        return 2;
+    auto float_sin = FoldedPolyApprox<float>::create<double>(sin, 64, PolyApproxFold::sine(2 * pi), 0, 0, 1e-3, PolyApproxFit::minimax);
+    if (check<float>(float_sin, sin, -100, 100, 2e-5))
+        return 3;
+
+    // the period of fixed32 is rounded to its resolution - the phase error grows with the argument
+    auto fixed_sin = FoldedPolyApprox<fixed32>::create<double>(sin, 64, PolyApproxFold::sine(2 * pi));
+    if (fixed_sin.isMaskFolded() || check<fixed32>(fixed_sin, sin, -100, 100, 1e-3))
+        return 4;
+
+    // a period of 4 is a power of two of raw units
+    auto fixed_quarter = FoldedPolyApprox<fixed32>::create<double>(sin_quarter, 32, PolyApproxFold::sine(4));
+    if (!fixed_quarter.isMaskFolded() || check<fixed32>(fixed_quarter, sin_quarter, -100, 100, 2e-4))
+        return 5;
+    auto shift_quarter = FoldedPolyApprox<fixed32, ShiftPolyApprox<fixed32>>::create<double>(sin_quarter, 32, PolyApproxFold::sine(4));
+    if (check<fixed32>(shift_quarter, sin_quarter, -100, 100, 2e-4))
+        return 6;
+
+    // parity only
+    PolyApproxFold even;
+    even.parity = PolyApproxParity::even;
+    auto square = FoldedPolyApprox<double>::create<double>([](double x) {return x * x;}, 16, even, 0.0, 4.0);
+    if (square(-3.0) != square(3.0) || std::abs(square(-3.0) - 9) > 1e-9)
+        return 7;
+
+    return 0;
+}
@@ -0,0 +1,55 @@
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <cmath>
+#include <array>
+#include <functional>
+
+#include "lib/fixedpoint.h"
+#include "lib/polyapprox.h"
+
+
+const std::array<std::function<double(double)>, 2> sin_cos{{[](double x) {return std::sin(x);}, [](double x) {return std::cos(x);}}};
+
+
+// multi is fitted with sin_cos on [-2, 2] in 64 parts
+template<typename T, typename Multi>
+int test(const Multi& multi, double max_error) {
+    PolyApprox<T> single_sin = PolyApprox<T>::template create<double>(sin, 64, -2, 2);
+    PolyApprox<T> single_cos = PolyApprox<T>::template create<double>(cos, 64, -2, 2);
+    for (double x=-2;x<2;x+=1e-3) {
+        const auto values = multi(T(x));
+        const auto derivatives = multi.derivative(T(x));
+        const auto integrals = multi.integral(T(x));
+        // the same parts as separate tables
+        if (values[0] != single_sin(T(x)) || values[1] != single_cos(T(x))) {
+            std::cout << "Error at test " << x << std::endl;
+            return 1;
+        }
+        if (std::abs((double)derivatives[0] - std::cos(x)) > 1e-2 || std::abs((double)derivatives[1] + std::sin(x)) > 1e-2) {
+            std::cout << "Error at test derivative " << x << std::endl;
+            return 2;
+        }
+        if (std::abs((double)integrals[0] - (std::cos(-2.0) - std::cos(x))) > max_error || std::abs((double)integrals[1] - (std::sin(x) - std::sin(-2.0))) > max_error) {
+            std::cout << "Error at test integral " << x << std::endl;
+            return 3;
+        }
+    }
+    return 0;
+}
+
+
+int main() {
+
+    if (test<double>(MultiPolyApprox<double, 2>(sin_cos, 64, -2.0, 2.0), 1e-6)) return 1;
+    if (test<double>(MultiPolyApprox<double, 2, 64>(sin_cos, -2.0, 2.0), 1e-6)) return 2;
+    if (test<float>(MultiPolyApprox<float, 2>::create<double>(sin_cos, 64, -2, 2), 1e-5)) return 3;
+    if (test<fixed32_a>(MultiPolyApprox<fixed32_a, 2>::create<double>(sin_cos, 64, -2, 2), 2e-3)) return 4;
+
+    // below the range the first part is used
+    MultiPolyApprox<double, 1> line(std::array<std::function<double(double)>, 1>{{[](double x) {return 2 * x;}}}, 4, 0.0, 1.0);
+    if (std::abs(line(-1.0)[0] + 2) > 1e-9 || std::abs(line.integral(1.0)[0] - 1) > 1e-9 || line.getPartCount() != 4)
+        return 5;
+
+    return 0;
+}
@@ -0,0 +1,63 @@
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+#include <cmath>
+
+#include "lib/fixedpoint.h"
+#include "lib/polyapprox.h"
+
+
+template<typename T, typename Approx>
+int check(const Approx& approx, double (*fun)(double, double), double x_min, double x_max, double y_min, double y_max, double max_error) {
+    std::vector<T> xs, ys;
+    double error = 0;
+    for (double x=x_min;x<=x_max;x+=(x_max-x_min)/97)
+        for (double y=y_min;y<=y_max;y+=(y_max-y_min)/89) {
+            xs.push_back(T(x));
+            ys.push_back(T(y));
+            error = std::max(error, std::abs((double)approx(T(x), T(y)) - fun((double)T(x), (double)T(y))));
+        }
+    if (error > max_error) {
+        std::cout << "Error at test " << error << std::endl;
+        return 1;
+    }
+    std::vector<T> out(xs.size());
+    approx.call_batch(xs.data(), ys.data(), out.data(), xs.size());
+    for (std::size_t i=0;i<xs.size();i++)
+        if (out[i] != approx(xs[i], ys[i])) {
+            std::cout << "Error at test batch " << i << std::endl;
+            return 2;
+        }
+    return 0;
+}
+
+
+double pow_xy(double x, double y) {
+    return std::pow(x, y);
+}
+
+
+int main() {
+
+    // atan2(y, x) for x > 0 - the first argument is y
+    auto double_atan2 = PolyApprox2D<double>::create<double>(atan2, 32, 32, -2.0, 2.0, 0.5, 2.0);
+    if (double_atan2.getPartCountX() != 32 || check<double>(double_atan2, atan2, -2.0, 2.0, 0.5, 2.0, 1e-4))
+        return 1;
+    auto double_pow = PolyApprox2D<double, 16, 16>::create<double>(pow_xy, 0.5, 2.0, 0.0, 2.0);
+    if (check<double>(double_pow, pow_xy, 0.5, 2.0, 0.0, 2.0, 1e-4))
+        return 2;
+    auto float_pow = PolyApprox2D<float>::create<double>(pow_xy, 16, 16, 0.5, 2.0, 0.0, 2.0);
+    if (check<float>(float_pow, pow_xy, 0.5, 2.0, 0.0, 2.0, 1e-4))
+        return 3;
+    auto fixed_atan2 = PolyApprox2D<fixed32_a>::create<double>(atan2, 32, 32, -2.0, 2.0, 0.5, 2.0);
+    if (check<fixed32_a>(fixed_atan2, atan2, -2.0, 2.0, 0.5, 2.0, 5e-4))
+        return 4;
+
+    // a bilinear function is reproduced exactly
+    auto bilinear = PolyApprox2D<double>::create<double>([](double x, double y) {return 1 + 2 * x - y + x * y;}, 4, 4, 0.0, 1.0, 0.0, 1.0);
+    if (std::abs(bilinear(0.3, 0.7) - (1 + 0.6 - 0.7 + 0.21)) > 1e-9)
+        return 5;
+
+    return 0;
+}
@@ -0,0 +1,85 @@
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <cmath>
+#include <vector>
+
+#include "lib/fixedpoint.h"
+#include "lib/taylormath.h"
+#include "lib/polyapprox.h"
+#include "lib/mathdispatch.h"
+#include "mathdispatch_choices.h"
+
+
+MATH_DISPATCH_SITE(test_std_sin, sin, float, -3, 3, 1e-6)
+MATH_DISPATCH_SITE(test_taylor_exp, exp, fixed64, -2, 2, 1e-6)
+MATH_DISPATCH_SITE(test_approx_cos, cos, fixed32, -3, 3, 1e-3)
+MATH_DISPATCH_SITE(test_mixed_sqrt, sqrt, fixed32_a, 0, 8, 1e-4)
+MATH_DISPATCH_SITE(test_default_log, log, fixed64, 0.5, 4, 1e-6)
+
+namespace math_dispatch {
+    template<> struct choice<test_std_sin> : selected<implementation::std_math, float> {};
+    template<> struct choice<test_taylor_exp> : selected<implementation::taylor, fixed64> {};
+    template<> struct choice<test_approx_cos> : selected<implementation::approx, fixed32> {
+        static const PolyApprox<fixed32>& table() {
+            static const PolyApprox<fixed32> approx = PolyApprox<fixed32>::create<double>(cos, 64, -3, 3);
+            return approx;
+        }
+    };
+    // the calculation type differs from the argument type
+    template<> struct choice<test_mixed_sqrt> : selected<implementation::std_math, double> {};
+}
+
+
+template<typename Site>
+double max_error(unsigned n=1000) {
+    double error = 0;
+    for (unsigned i=0;i<n;i++) {
+        const typename Site::type x = Site::min() + (Site::max() - Site::min()) * i / n;
+        const double e = std::abs((double)math_dispatch::call<Site>(x) - Site::function::reference((double)x));
+        error = (e > error) ? e : error;
+    }
+    return error;
+}
+
+
+int main() {
+
+    // the dispatch is a direct call of the chosen implementation
+    for (int i=-30;i<=30;i++) {
+        const float x = i * 0.1f;
+        if (math_dispatch::call<test_std_sin>(x) != std::sin(x)) {
+            std::cout << "Error at test std " << x << std::endl;
+            return 1;
+        }
+        if (math_dispatch::call<test_taylor_exp>(fixed64(x / 1.5f)) != taylor::exp<fixed64>(fixed64(x / 1.5f))) {
+            std::cout << "Error at test taylor " << x << std::endl;
+            return 1;
+        }
+        if (math_dispatch::call<test_approx_cos>(fixed32(x)) != math_dispatch::choice<test_approx_cos>::table()(fixed32(x))) {
+            std::cout << "Error at test approx " << x << std::endl;
+            return 1;
+        }
+    }
+    // the default choice is taylormath of the argument type
+    if (math_dispatch::choice<test_default_log>::impl != math_dispatch::implementation::taylor
+            || math_dispatch::call<test_default_log>(fixed64(1.5)) != taylor::log<fixed64>(fixed64(1.5))) {
+        std::cout << "Error at test default" << std::endl;
+        return 1;
+    }
+    if (max_error<test_mixed_sqrt>() > test_mixed_sqrt::max_error() || max_error<test_approx_cos>() > test_approx_cos::max_error()) {
+        std::cout << "Error at test accuracy" << std::endl;
+        return 1;
+    }
+
+    // the sites of the project meet their targets with the default and the tuned choices
+    #define TEST_SITE(site, fun, T, range_min, range_max, error) \
+        if (max_error<site>() > site::max_error()) { \
+            std::cout << "Error at test " << #site << " " << max_error<site>() << std::endl; \
+            return 1; \
+        }
+    MATH_DISPATCH_SITES(TEST_SITE)
+    #undef TEST_SITE
+
+    return 0;
+}
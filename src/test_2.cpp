@@ -1,127 +1,112 @@
 #include <cstdio>
 #include <cstdlib>
 #include <iostream>
-#include <fstream>
 #include <cmath>
 #include <string>
-#include <functional>
-#include <iomanip>
+#include <vector>
+#include <sstream>
 
 #define TAYLOR_LOOP_COUNTER 1
 
 #include "lib/fixedpoint.h"
 #include "lib/taylormath.h"
 #include "lib/polyapprox.h"
+#include "lib/mathsweep.h"
+
+// Accuracy and cost sweep - by default the 101 points per function read by plots/plot.py and plots/sweep.tsv.
+//
+// usage: test_2 [--samples N] [--exhaustive] [--threads N] [--types a,b] [--groups std,taylor,approx] [--functions a,b]
+//               [--parts N,M] [--fit hermite|chebyshev|minimax] [--output file] [--plots directory|-]
+
+
+std::vector<std::string> split(const std::string& list) {
+    std::vector<std::string> items;
+    std::stringstream stream(list);
+    std::string item;
+    while (std::getline(stream, item, ','))
+        if (!item.empty())
+            items.push_back(item);
+    return items;
+}
 
-template<typename T>
-void test_function(const std::string& filename, double start, double stop, unsigned n, const std::function<T(T)> fun) {
-    std::ofstream file(filename);
-    file << std::fixed << std::setw(32) << std::setprecision(32);
-    // initialize if needed
-    fun(start);
-    fun((stop+start)/2);
-    fun(stop);
-    for (unsigned i=0;i<n;i++) {
-        taylor::loop_counter = 0;
-        double x = start + i * (stop - start) / n;
-        const auto value = fun(x);
-        file << x << "\t" << value << "\t" << taylor::loop_counter << "\n";
+bool parse(int argc, char** argv, math_sweep::config& cfg, std::string& output) {
+    for (int i=1;i<argc;i++) {
+        const std::string arg = argv[i];
+        if (arg == "--exhaustive") {
+            cfg.mode = math_sweep::sampling::exhaustive;
+            continue;
+        }
+        if (i + 1 >= argc)
+            return false;
+        const std::string value = argv[++i];
+        if (arg == "--samples")
+            cfg.samples = std::max(1, std::atoi(value.c_str()));
+        else if (arg == "--threads")
+            cfg.threads = std::max(1, std::atoi(value.c_str()));
+        else if (arg == "--types")
+            cfg.types = split(value);
+        else if (arg == "--groups")
+            cfg.groups = split(value);
+        else if (arg == "--functions")
+            cfg.functions = split(value);
+        else if (arg == "--parts") {
+            cfg.parts.clear();
+            for (const auto& parts : split(value))
+                cfg.parts.push_back(std::max(1, std::atoi(parts.c_str())));
+        }
+        else if (arg == "--fit") {
+            if (value == "hermite") cfg.fit = PolyApproxFit::hermite;
+            else if (value == "chebyshev") cfg.fit = PolyApproxFit::chebyshev;
+            else if (value == "minimax") cfg.fit = PolyApproxFit::minimax;
+            else return false;
+        }
+        else if (arg == "--output")
+            output = value;
+        else if (arg == "--plots")
+            cfg.plots_directory = value == "-" ? "" : value;
+        else
+            return false;
     }
-    file.close();
+    return !cfg.parts.empty();
 }
 
-int main() {
-
-    unsigned n = 101;
-
-    test_function<double>("plots/double_std_cos.txt", -10, 10, n, cos);
-    test_function<double>("plots/double_std_sin.txt", -10, 10, n, sin);
-    test_function<double>("plots/double_std_sqrt.txt", 0, 16, n, sqrt);
-    test_function<double>("plots/double_std_asin.txt", -1, 1, n, asin);
-    test_function<double>("plots/double_std_log.txt", 1e-3, 10, n, log);
-    test_function<double>("plots/double_std_exp.txt", -10, 10, n, exp);
-
-    test_function<double>("plots/double_taylor_cos.txt", -10, 10, n, taylor::cos<double>);
-    test_function<double>("plots/double_taylor_sin.txt", -10, 10, n, taylor::sin<double>);
-    test_function<double>("plots/double_taylor_sqrt.txt", 0, 16, n, taylor::sqrt<double>);
-    test_function<double>("plots/double_taylor_asin.txt", -1, 1, n, taylor::asin<double>);
-    test_function<double>("plots/double_taylor_log.txt", 1e-3, 10, n, taylor::log<double>);
-    test_function<double>("plots/double_taylor_exp.txt", -10, 10, n, taylor::exp<double>);
-
-    test_function<float>("plots/float_std_cos.txt", -10, 10, n, cos);
-    test_function<float>("plots/float_std_sin.txt", -10, 10, n, sin);
-    test_function<float>("plots/float_std_sqrt.txt", 0, 16, n, sqrt);
-    test_function<float>("plots/float_std_asin.txt", -1, 1, n, asin);
-    test_function<float>("plots/float_std_log.txt", 1e-3, 10, n, log);
-    test_function<float>("plots/float_std_exp.txt", -10, 10, n, exp);
-
-    test_function<float>("plots/float_taylor_cos.txt", -10, 10, n, taylor::cos<float>);
-    test_function<float>("plots/float_taylor_sin.txt", -10, 10, n, taylor::sin<float>);
-    test_function<float>("plots/float_taylor_sqrt.txt", 0, 16, n, taylor::sqrt<float>);
-    test_function<float>("plots/float_taylor_asin.txt", -1, 1, n, taylor::asin<float>);
-    test_function<float>("plots/float_taylor_log.txt", 1e-3, 10, n, taylor::log<float>);
-    test_function<float>("plots/float_taylor_exp.txt", -10, 10, n, taylor::exp<float>);
-
-    test_function<fixed32_s>("plots/fixed32_s_taylor_cos.txt", -10, 10, n, taylor::cos<fixed32_s>);
-    test_function<fixed32_s>("plots/fixed32_s_taylor_sin.txt", -10, 10, n, taylor::sin<fixed32_s>);
-    test_function<fixed32_s>("plots/fixed32_s_taylor_sqrt.txt", 0, 16, n, taylor::sqrt<fixed32_s>);
-    test_function<fixed32_s>("plots/fixed32_s_taylor_asin.txt", -1, 1, n, taylor::asin<fixed32_s>);
-    test_function<fixed32_s>("plots/fixed32_s_taylor_log.txt", 1e-3, 10, n, taylor::log<fixed32_s>);
-    test_function<fixed32_s>("plots/fixed32_s_taylor_exp.txt", -10, 10, n, taylor::exp<fixed32_s>);
-
-    test_function<fixed32_a>("plots/fixed32_a_taylor_cos.txt", -10, 10, n, taylor::cos<fixed32_a>);
-    test_function<fixed32_a>("plots/fixed32_a_taylor_sin.txt", -10, 10, n, taylor::sin<fixed32_a>);
-    test_function<fixed32_a>("plots/fixed32_a_taylor_sqrt.txt", 0, 16, n, taylor::sqrt<fixed32_a>);
-    test_function<fixed32_a>("plots/fixed32_a_taylor_asin.txt", -1, 1, n, taylor::asin<fixed32_a>);
-    test_function<fixed32_a>("plots/fixed32_a_taylor_log.txt", 1e-3, 10, n, taylor::log<fixed32_a>);
-    test_function<fixed32_a>("plots/fixed32_a_taylor_exp.txt", -10, 10, n, taylor::exp<fixed32_a>);
-
-    test_function<fixed64>("plots/fixed64_taylor_cos.txt", -10, 10, n, taylor::cos<fixed64>);
-    test_function<fixed64>("plots/fixed64_taylor_sin.txt", -10, 10, n, taylor::sin<fixed64>);
-    test_function<fixed64>("plots/fixed64_taylor_sqrt.txt", 0, 16, n, taylor::sqrt<fixed64>);
-    test_function<fixed64>("plots/fixed64_taylor_asin.txt", -1, 1, n, taylor::asin<fixed64>);
-    test_function<fixed64>("plots/fixed64_taylor_log.txt", 1e-3, 10, n, taylor::log<fixed64>);
-    test_function<fixed64>("plots/fixed64_taylor_exp.txt", -10, 10, n, taylor::exp<fixed64>);
 
-    unsigned m = 31;
-
-    test_function<float>("plots/float_approx_cos.txt", -10, 10, n, PolyApprox<float>::create<double>(cos, m, -10, 10, 1e-3));
-    test_function<float>("plots/float_approx_sin.txt", -10, 10, n, PolyApprox<float>::create<double>(sin, m, -10, 10, 1e-3));
-    test_function<float>("plots/float_approx_sqrt.txt", 0, 16, n, PolyApprox<float>::create<double>(sqrt, m, 0, 16, 1e-3));
-    test_function<float>("plots/float_approx_asin.txt", -1, 1, n, PolyApprox<float>::create<double>(asin, m, -1, 1, 1e-3));
-    test_function<float>("plots/float_approx_log.txt", 1e-3, 10, n, PolyApprox<float>::create<double>(log, m, 1e-3, 10, 1e-3));
-    test_function<float>("plots/float_approx_exp.txt", -10, 10, n, PolyApprox<float>::create<double>(exp, m, -10, 10, 1e-3));
-
-    test_function<double>("plots/double_approx_cos.txt", -10, 10, n, PolyApprox<double>::create<double>(cos, m, -10, 10, 1e-3));
-    test_function<double>("plots/double_approx_sin.txt", -10, 10, n, PolyApprox<double>::create<double>(sin, m, -10, 10, 1e-3));
-    test_function<double>("plots/double_approx_sqrt.txt", 0, 16, n, PolyApprox<double>::create<double>(sqrt, m, 0, 16, 1e-3));
-    test_function<double>("plots/double_approx_asin.txt", -1, 1, n, PolyApprox<double>::create<double>(asin, m, -1, 1, 1e-3));
-    test_function<double>("plots/double_approx_log.txt", 1e-3, 10, n, PolyApprox<double>::create<double>(log, m, 1e-3, 10, 1e-3));
-    test_function<double>("plots/double_approx_exp.txt", -10, 10, n, PolyApprox<double>::create<double>(exp, m, -10, 10, 1e-3));
-
-    test_function<fixed32_s>("plots/fixed32_s_approx_cos.txt", -10, 10, n, PolyApprox<fixed32_s>::create<double>(cos, m, -10, 10, 1e-3));
-    test_function<fixed32_s>("plots/fixed32_s_approx_sin.txt", -10, 10, n, PolyApprox<fixed32_s>::create<double>(sin, m, -10, 10, 1e-3));
-    test_function<fixed32_s>("plots/fixed32_s_approx_sqrt.txt", 0, 16, n, PolyApprox<fixed32_s>::create<double>(sqrt, m, 0, 16, 1e-3));
-    test_function<fixed32_s>("plots/fixed32_s_approx_asin.txt", -1, 1, n, PolyApprox<fixed32_s>::create<double>(asin, m, -1, 1, 1e-3));
-    test_function<fixed32_s>("plots/fixed32_s_approx_log.txt", 1e-3, 10, n, PolyApprox<fixed32_s>::create<double>(log, m, 1e-3, 10, 1e-3));
-    test_function<fixed32_s>("plots/fixed32_s_approx_exp.txt", -10, 10, n, PolyApprox<fixed32_s>::create<double>(exp, m, -10, 10, 1e-3));
-
-    test_function<fixed32_a>("plots/fixed32_a_approx_cos.txt", -10, 10, n, PolyApprox<fixed32_a>::create<double>(cos, m, -10, 10, 1e-3));
-    test_function<fixed32_a>("plots/fixed32_a_approx_sin.txt", -10, 10, n, PolyApprox<fixed32_a>::create<double>(sin, m, -10, 10, 1e-3));
-    test_function<fixed32_a>("plots/fixed32_a_approx_sqrt.txt", 0, 16, n, PolyApprox<fixed32_a>::create<double>(sqrt, m, 0, 16, 1e-3));
-    test_function<fixed32_a>("plots/fixed32_a_approx_asin.txt", -1, 1, n, PolyApprox<fixed32_a>::create<double>(asin, m, -1, 1, 1e-3));
-    test_function<fixed32_a>("plots/fixed32_a_approx_log.txt", 1e-3, 10, n, PolyApprox<fixed32_a>::create<double>(log, m, 1e-3, 10, 1e-3));
-    test_function<fixed32_a>("plots/fixed32_a_approx_exp.txt", -10, 10, n, PolyApprox<fixed32_a>::create<double>(exp, m, -10, 10, 1e-3));
-
-    test_function<fixed64>("plots/fixed64_approx_cos.txt", -10, 10, n, PolyApprox<fixed64>::create<double>(cos, m, -10, 10, 1e-3));
-    test_function<fixed64>("plots/fixed64_approx_sin.txt", -10, 10, n, PolyApprox<fixed64>::create<double>(sin, m, -10, 10, 1e-3));
-    test_function<fixed64>("plots/fixed64_approx_sqrt.txt", 0, 16, n, PolyApprox<fixed64>::create<double>(sqrt, m, 0, 16, 1e-3));
-    test_function<fixed64>("plots/fixed64_approx_asin.txt", -1, 1, n, PolyApprox<fixed64>::create<double>(asin, m, -1, 1, 1e-3));
-    test_function<fixed64>("plots/fixed64_approx_log.txt", 1e-3, 10, n, PolyApprox<fixed64>::create<double>(log, m, 1e-3, 10, 1e-3));
-    test_function<fixed64>("plots/fixed64_approx_exp.txt", -10, 10, n, PolyApprox<fixed64>::create<double>(exp, m, -10, 10, 1e-3));
+int main(int argc, char** argv) {
 
+    math_sweep::config cfg;
+    cfg.plots_directory = "plots";
+    std::string output = "plots/sweep.tsv";
+    if (!parse(argc, argv, cfg, output)) {
+        std::cerr << "usage: test_2 [--samples N] [--exhaustive] [--threads N] [--types a,b] [--groups std,taylor,approx] [--functions a,b]"
+                  << " [--parts N,M] [--fit hermite|chebyshev|minimax] [--output file] [--plots directory|-]" << std::endl;
+        return 2;
+    }
 
+    std::vector<math_sweep::sweep_case> cases;
+    math_sweep::add_type<double>(cases, "double", cfg);
+    math_sweep::add_type<float>(cases, "float", cfg);
+    math_sweep::add_type<fixed32_s>(cases, "fixed32_s", cfg);
+    math_sweep::add_type<fixed32_a>(cases, "fixed32_a", cfg);
+    math_sweep::add_type<fixed64>(cases, "fixed64", cfg);
+
+    const auto results = math_sweep::run(cases, cfg);
+    if (!math_sweep::write_results(output, results)) {
+        std::cout << "Error at test: cannot write " << output << std::endl;
+        return 1;
+    }
 
+    for (const auto& r : results) {
+        if (r.samples == 0 || !std::isfinite(r.ns_per_call)) {
+            std::cout << "Error at test: " << r.type << " " << r.group << " " << r.function << std::endl;
+            return 1;
+        }
+        // the series of double are accurate, the loop counter works on all threads
+        if (r.type == "double" && r.group == "taylor" && (r.function == "sin" || r.function == "exp")
+                && (r.max_error > 1e-9 * std::exp(r.stop) || r.max_loops == 0)) {
+            std::cout << "Error at test: " << r.type << " " << r.group << " " << r.function << " error " << r.max_error << std::endl;
+            return 1;
+        }
+    }
 
     return 0;
 }
@@ -0,0 +1,99 @@
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <cmath>
+#include <string>
+#include <thread>
+#include <vector>
+
+#define MATH_STATS 1
+
+#include "lib/fixedpoint.h"
+#include "lib/taylormath.h"
+#include "lib/polyapprox.h"
+#include "lib/mathstats.h"
+
+
+const math_stats::function_stats* find(const std::vector<math_stats::function_stats>& stats, const std::string& function, const std::string& type) {
+    for (const auto& s : stats)
+        if (s.function == function && s.type == type)
+            return &s;
+    return nullptr;
+}
+
+std::uint64_t histogram_sum(const math_stats::function_stats& stats) {
+    std::uint64_t sum = 0;
+    for (auto count : stats.histogram)
+        sum += count;
+    return sum;
+}
+
+bool check(const std::vector<math_stats::function_stats>& stats, const std::string& function, const std::string& type,
+           std::uint64_t calls, bool iterations) {
+    const math_stats::function_stats* s = find(stats, function, type);
+    if (!s || s->calls != calls || histogram_sum(*s) != calls || (iterations && (s->iterations == 0 || s->max_iterations == 0))
+            || s->max_iterations * s->calls < s->iterations || math_stats::quantile(*s, 0.5) > math_stats::quantile(*s, 1)) {
+        std::cout << "Error at test: " << function << " " << type << " calls " << (s ? s->calls : 0) << " expected " << calls
+                  << ", iterations " << (s ? s->iterations : 0) << ", median below " << (s ? math_stats::quantile(*s, 0.5) : 0) << " cycles" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+
+int main() {
+
+    volatile double sum = 0;
+
+    // calls of one thread, the nested taylor::sqrt of taylor::ln is a part of the ln call
+    for (int i=0;i<100;i++)
+        sum = sum + (double)taylor::sin<double>(i * 0.1);
+    for (int i=1;i<=50;i++)
+        sum = sum + (double)taylor::ln<fixed64>(fixed64(i * 0.5));
+
+    auto stats = math_stats::snapshot();
+    if (!check(stats, "taylor::sin", "double", 100, true) || !check(stats, "taylor::ln", math_stats::type_name<fixed64>::get(), 50, true))
+        return 1;
+    if (find(stats, "taylor::sqrt", math_stats::type_name<fixed64>::get())) {
+        std::cout << "Error at test: nested call recorded" << std::endl;
+        return 1;
+    }
+
+    // counters of finished threads are kept
+    std::vector<std::thread> threads;
+    for (int t=0;t<4;t++)
+        threads.emplace_back([t]() {
+            volatile double local = 0;
+            for (int i=0;i<250;i++)
+                local = local + (double)taylor::exp<fixed32_a>(fixed32_a(t - i * 0.01));
+        });
+    for (auto& t : threads)
+        t.join();
+
+    const PolyApprox<fixed32> approx = PolyApprox<fixed32>::create<double>(cos, 32, -3, 3);
+    const AdaptivePolyApprox<double> adaptive = AdaptivePolyApprox<double>::create<double>(exp, 1e-6, -2, 2);
+    for (int i=0;i<200;i++) {
+        sum = sum + (double)approx(fixed32(-3 + i * 0.03));
+        sum = sum + adaptive(-2 + i * 0.02);
+    }
+
+    stats = math_stats::snapshot();
+    if (!check(stats, "taylor::exp", math_stats::type_name<fixed32_a>::get(), 1000, true) || !check(stats, "PolyApprox::call", math_stats::type_name<fixed32>::get(), 200, false)
+            || !check(stats, "AdaptivePolyApprox::call", "double", 200, true))
+        return 1;
+
+    math_stats::reset();
+    stats = math_stats::snapshot();
+    for (const auto& s : stats) {
+        if (s.calls != 0 || s.cycles != 0 || histogram_sum(s) != 0) {
+            std::cout << "Error at test: reset " << s.function << std::endl;
+            return 1;
+        }
+    }
+    sum = sum + (double)taylor::sin<double>(1);
+    stats = math_stats::snapshot();
+    if (!check(stats, "taylor::sin", "double", 1, true))
+        return 1;
+
+    return 0;
+}
@@ -8,5 +8,21 @@ int main() {
 
     PolyApprox<fixed32, 10> static_object = PolyApprox<fixed32, 10>::create<double>(sin, -1, 1);
 
+    PolyApprox<fixed32> dynamic_cos = PolyApprox<fixed32>::create<double>(cos, 10, -1, 1);
+
+    std::pair<fixed32, fixed32> sc = dynamic_object.call_pair(dynamic_cos, 0.5);
+    if (sc.first != dynamic_object(0.5) || sc.second != dynamic_cos(0.5))
+        return 1;
+
+    // 8 lane blocks and the tail
+    fixed32 in[37], out[37], static_out[37];
+    for (unsigned i=0;i<37;i++)
+        in[i] = -1.2 + i * (2.4 / 37);
+    dynamic_object.call_batch(in, out, 37);
+    static_object.call_batch(in, static_out, 37);
+    for (unsigned i=0;i<37;i++)
+        if (out[i] != dynamic_object(in[i]) || static_out[i] != static_object(in[i]))
+            return 2;
+
     return std::floor(dynamic_object(0) + static_object(0));
 }
@@ -0,0 +1,108 @@
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <cmath>
+#include <vector>
+#include <functional>
+
+#include "lib/fixedpoint.h"
+#include "lib/taylormath.h"
+
+
+int status_code = 0;
+unsigned long long test_no = 0;
+
+
+template<typename FP>
+void compare(const char* name, float start, float stop, float step, float epsilon, float relative,
+             const std::function<void(const FP*, FP*, std::size_t)>& batch, const std::function<double(double)>& reference) {
+    std::vector<FP> in;
+    for (float x=start;x<stop;x+=step)
+        in.push_back(FP(x));
+    std::vector<FP> out(in.size());
+    batch(in.data(), out.data(), in.size());
+    for (std::size_t i=0;i<in.size();i++) {
+        test_no++;
+        double x = (double)in[i];
+        double expected = reference(x);
+        double got = (double)out[i];
+        if (std::abs(expected - got) > epsilon + relative * std::abs(expected)) {
+            std::cout << "Error at test " << test_no << " (" << name << ") at x = " << x << " : " << " expected: " << expected << " got: " << got << std::endl;
+            status_code = 1;
+        }
+    }
+}
+
+
+template<typename FP>
+std::function<void(const FP*, FP*, std::size_t)> scalar(FP (*f)(FP)) {
+    return [f](const FP* in, FP* out, std::size_t n) {
+        for (std::size_t i=0;i<n;i++)
+            out[i] = f(in[i]);
+    };
+}
+
+
+template<typename FP>
+void test(float epsilon) {
+    compare<FP>("sin_n", -10, 10, 2.5e-2, epsilon, 0, taylor::sin_n<FP>, [](double x) {return std::sin(x);});
+    compare<FP>("cos_n", -10, 10, 2.5e-2, epsilon, 0, taylor::cos_n<FP>, [](double x) {return std::cos(x);});
+    compare<FP>("sqrt_n", 0, 20, 1e-2, epsilon, 0, taylor::sqrt_n<FP>, [](double x) {return std::sqrt(x);});
+    compare<FP>("asin_n", -0.999, 0.999, 1e-2, epsilon, 0, taylor::asin_n<FP>, [](double x) {return std::asin(x);});
+    compare<FP>("ln_n", 1e-2, 10, 1e-2, 2 * epsilon, 0, taylor::ln_n<FP>, [](double x) {return std::log(x);});
+    compare<FP>("exp_n", -8, 8, 2.5e-2, epsilon, 1e-2, taylor::exp_n<FP>, [](double x) {return std::exp(x);});
+
+    // tail shorter than the block
+    FP in[3] = {FP(0.5), FP(1), FP(2)};
+    FP sine[3], cosine[3];
+    taylor::sincos_n<FP>(in, sine, cosine, 3);
+    for (unsigned i=0;i<3;i++) {
+        test_no++;
+        double x = (double)in[i];
+        if (std::abs((double)sine[i] - std::sin(x)) > epsilon || std::abs((double)cosine[i] - std::cos(x)) > epsilon) {
+            std::cout << "Error at test " << test_no << " (sincos_n) at x = " << x << std::endl;
+            status_code = 1;
+        }
+    }
+
+    // single lane functions
+    compare<FP>("constant_latency::sin", -10, 10, 2.5e-2, epsilon, 0, scalar<FP>(taylor::constant_latency::sin<FP>), [](double x) {return std::sin(x);});
+    compare<FP>("constant_latency::cos", -10, 10, 2.5e-2, epsilon, 0, scalar<FP>(taylor::constant_latency::cos<FP>), [](double x) {return std::cos(x);});
+    compare<FP>("constant_latency::sqrt", 0, 20, 1e-2, epsilon, 0, scalar<FP>(taylor::constant_latency::sqrt<FP>), [](double x) {return std::sqrt(x);});
+    compare<FP>("constant_latency::asin", -0.999, 0.999, 1e-2, epsilon, 0, scalar<FP>(taylor::constant_latency::asin<FP>), [](double x) {return std::asin(x);});
+    compare<FP>("constant_latency::ln", 1e-2, 10, 1e-2, 2 * epsilon, 0, scalar<FP>(taylor::constant_latency::ln<FP>), [](double x) {return std::log(x);});
+    compare<FP>("constant_latency::exp", -8, 8, 2.5e-2, epsilon, 1e-2, scalar<FP>(taylor::constant_latency::exp<FP>), [](double x) {return std::exp(x);});
+    compare<FP>("constant_latency::sinh", -5, 5, 2.5e-2, epsilon, 1e-2, scalar<FP>(taylor::constant_latency::sinh<FP>), [](double x) {return std::sinh(x);});
+    compare<FP>("constant_latency::cosh", -5, 5, 2.5e-2, epsilon, 1e-2, scalar<FP>(taylor::constant_latency::cosh<FP>), [](double x) {return std::cosh(x);});
+    compare<FP>("constant_latency::tanh", -10, 10, 2.5e-2, epsilon, 0, scalar<FP>(taylor::constant_latency::tanh<FP>), [](double x) {return std::tanh(x);});
+}
+
+
+// relative error of sinh for |x| down to 1e-8 - only the floating point types resolve it
+template<typename FP>
+void test_small_sinh(double relative) {
+    for (double x=1e-8;x<=1;x*=1.5) {
+        for (double v : {x, -x}) {
+            test_no++;
+            double expected = std::sinh((double)FP(v));
+            double got = (double)taylor::constant_latency::sinh<FP>(FP(v));
+            if (std::abs(expected - got) > relative * std::abs(expected)) {
+                std::cout << "Error at test " << test_no << " (constant_latency::sinh) at x = " << v << " : " << " expected: " << expected << " got: " << got << std::endl;
+                status_code = 1;
+            }
+        }
+    }
+}
+
+
+int main() {
+
+    test<fixed32_a>(2e-3);
+    test<fixed64>(2e-4);
+    test<float>(1e-5);
+    test<double>(1e-10);
+    test_small_sinh<float>(1e-6);
+    test_small_sinh<double>(1e-14);
+
+    return status_code;
+}
@@ -0,0 +1,73 @@
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <cmath>
+#include <functional>
+
+#include "lib/fixedpoint.h"
+#include "lib/polyapprox.h"
+
+
+int status_code = 0;
+unsigned long long test_no = 0;
+
+
+template<typename FP, typename Approx>
+void compare(const char* name, const Approx& approx, double start, double stop, double step, double epsilon, const std::function<double(double)>& reference) {
+    for (double x=start;x<stop;x+=step) {
+        test_no++;
+        double expected = reference(x);
+        double got = (double)approx(FP(x));
+        if (std::abs(expected - got) > epsilon) {
+            std::cout << "Error at test " << test_no << " (" << name << ") at x = " << x << " : " << " expected: " << expected << " got: " << got << std::endl;
+            status_code = 1;
+        }
+    }
+}
+
+
+template<typename FP>
+void test(double epsilon) {
+    // width 1/4 - the range is covered exactly
+    ShiftPolyApprox<FP> sine = ShiftPolyApprox<FP>::template create<double>(sin, 40, -5, 5);
+    if (sine.getWidthLog2() != -2 || sine.getPartCount() != 40) {
+        std::cout << "Error at test " << test_no << " (sin) width 2^" << sine.getWidthLog2() << " parts " << sine.getPartCount() << std::endl;
+        status_code = 1;
+    }
+    compare<FP>("sin", sine, -5, 5, 1e-2, epsilon, [](double x) {return std::sin(x);});
+
+    // the last part is shorter (range 3.2, width 1/8)
+    ShiftPolyApprox<FP> exponent = ShiftPolyApprox<FP>::template create<double>(exp, 30, -1.6, 1.6);
+    compare<FP>("exp", exponent, -1.6, 1.6, 1e-2, 5 * epsilon, [](double x) {return std::exp(x);});
+
+    // arguments outside of the range use the first and the last part
+    PolyApprox<FP> reference = PolyApprox<FP>::template create<double>(sin, 40, -5, 5);
+    compare<FP>("sin above", sine, 5, 5.1, 1e-2, 10 * epsilon, [&reference](double x) {return (double)reference(FP(x));});
+    compare<FP>("sin below", sine, -5.05, -5, 1e-2, 10 * epsilon, [](double x) {return std::sin(x);});
+
+    FP in[21], out[21];
+    for (unsigned i=0;i<21;i++)
+        in[i] = FP(-5.5 + i * 0.55);
+    sine.call_batch(in, out, 21);
+    for (unsigned i=0;i<21;i++) {
+        test_no++;
+        if (out[i] != sine(in[i])) {
+            std::cout << "Error at test " << test_no << " (call_batch) at x = " << (double)in[i] << std::endl;
+            status_code = 1;
+        }
+    }
+
+    ShiftPolyApprox<FP, 32> static_sqrt = ShiftPolyApprox<FP, 32>::template create<double>(sqrt, 1, 9);
+    compare<FP>("static sqrt", static_sqrt, 1, 9, 1e-2, epsilon, [](double x) {return std::sqrt(x);});
+}
+
+
+int main() {
+
+    test<fixed32_a>(1e-3);
+    test<fixed64>(1e-3);
+    test<float>(1e-4);
+    test<double>(1e-4);
+
+    return status_code;
+}
@@ -0,0 +1,59 @@
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <cmath>
+#include <functional>
+
+#include "lib/fixedpoint.h"
+#include "lib/polyapprox.h"
+
+
+int status_code = 0;
+unsigned long long test_no = 0;
+
+
+template<typename FP>
+void compare(const char* name, const AdaptivePolyApprox<FP>& approx, double start, double stop, double step, double epsilon, const std::function<double(double)>& reference) {
+    for (double x=start;x<stop;x+=step) {
+        test_no++;
+        double expected = reference(x);
+        double got = (double)approx(FP(x));
+        if (std::abs(expected - got) > epsilon) {
+            std::cout << "Error at test " << test_no << " (" << name << ") at x = " << x << " : " << " expected: " << expected << " got: " << got << std::endl;
+            status_code = 1;
+        }
+    }
+}
+
+
+// log_min and asin_max - the quantization of the argument of fixed point types gives large errors near the singularities
+template<typename FP>
+void test(double max_error, double epsilon, double log_min, double asin_max, unsigned max_log_parts) {
+    AdaptivePolyApprox<FP> logarithm = AdaptivePolyApprox<FP>::template create<double>(log, max_error, log_min, 10);
+    compare<FP>("log", logarithm, log_min, 10, 1e-4, epsilon, [](double x) {return std::log(x);});
+    if (logarithm.getPartCount() > max_log_parts) {
+        std::cout << "Error at test " << test_no << " (log) too many parts: " << logarithm.getPartCount() << std::endl;
+        status_code = 1;
+    }
+
+    AdaptivePolyApprox<FP> arcsine = AdaptivePolyApprox<FP>::template create<double>(asin, max_error, -asin_max, asin_max);
+    compare<FP>("asin", arcsine, -asin_max, asin_max, 1e-4, epsilon, [](double x) {return std::asin(x);});
+
+    // above the range - the last part
+    test_no++;
+    double above = (double)logarithm(FP(10.5));
+    if (std::abs(above - std::log(10.5)) > 1e-2) {
+        std::cout << "Error at test " << test_no << " (log outside) got: " << above << std::endl;
+        status_code = 1;
+    }
+}
+
+
+int main() {
+
+    test<fixed32_a>(1e-3, 2e-3, 0.05, 0.99, 100);
+    test<float>(1e-5, 2e-5, 1e-2, 0.999, 400);
+    test<double>(1e-6, 2e-6, 1e-3, 1, 1000);
+
+    return status_code;
+}
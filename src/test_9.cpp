@@ -0,0 +1,78 @@
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <cmath>
+
+#include "lib/fixedpoint.h"
+#include "lib/polyapprox.h"
+#include "lib/polyapprox_codegen.h"
+
+
+// y = x + 1 on [-1, 1] in two parts - a table in the form emitted by polyapprox_codegen::toHeader
+constexpr PolyApprox<fixed32, 2> line(
+    PolyApprox<fixed32, 2>::table_type{{
+        {{fixed32::buf_cast(0), fixed32::buf_cast(32768), fixed32::buf_cast(0), fixed32::buf_cast(0), fixed32::buf_cast(-32768)}},
+        {{fixed32::buf_cast(32768), fixed32::buf_cast(32768), fixed32::buf_cast(0), fixed32::buf_cast(0), fixed32::buf_cast(0)}}
+    }},
+    fixed32::buf_cast(-32768),
+    fixed32::buf_cast(32768)
+);
+
+static_assert(line.getRangeMin().getBuf() == -32768, "constexpr table");
+
+
+template<typename T, unsigned part_count>
+int round_trip(const PolyApprox<T>& fitted) {
+    typename PolyApprox<T, part_count>::table_type table;
+    for (unsigned i=0;i<part_count;i++)
+        table[i] = fitted.getCoefficients(i);
+    PolyApprox<T, part_count> copy(table, fitted.getRangeMin(), fitted.getInvIncrementator());
+    for (double x=-1;x<1;x+=1e-2)
+        if (copy(T(x)) != fitted(T(x)))
+            return 1;
+    return 0;
+}
+
+
+int main() {
+
+    if (line(fixed32(0.5)) != fixed32(1.5) || line(fixed32(-0.25)) != fixed32(0.75))
+        return 1;
+
+    PolyApprox<fixed32> fixed_sin = PolyApprox<fixed32>::create<double>(sin, 8, -1, 1);
+    PolyApprox<float> float_exp = PolyApprox<float>::create<double>(exp, 8, -1, 1);
+    if (round_trip<fixed32, 8>(fixed_sin) || round_trip<float, 8>(float_exp))
+        return 2;
+
+    std::ostringstream header;
+    polyapprox_codegen::toHeader(header, fixed_sin, "sin_table", "fixed32");
+    const std::string text = header.str();
+    if (text.find("constexpr PolyApprox<fixed32, 8> sin_table(") == std::string::npos)
+        return 3;
+    if (text.find("fixed32::buf_cast(" + std::to_string(fixed_sin.getCoefficients(0)[0].getBuf()) + ")") == std::string::npos)
+        return 4;
+
+    std::ostringstream float_header;
+    polyapprox_codegen::toHeader(float_header, float_exp, "exp_table", "float");
+    if (float_header.str().find("-1.00000000e+00f") == std::string::npos || float_header.str().find("fixedpoint.h") != std::string::npos)
+        return 5;
+
+#if __cplusplus >= 201703L
+    // built with C++17 as test_9_cpp17 by builder.py
+    constexpr auto cube = PolyApprox<double, 8>::fit_constexpr<double>([](double x) {return x*x*x - x;}, -1.0, 1.0);
+    static_assert(cube.getCoefficients(0)[4] == -1.0 && cube.getCoefficients(4)[4] == 0.0, "constexpr fit nodes");
+    static_assert(cube.getCoefficients(0)[0] == 0.0 && cube.getCoefficients(6)[0] == 0.125 - 0.5, "constexpr fit values");
+    static_assert(cube.getCoefficients(4)[1] > -1.0001 && cube.getCoefficients(4)[1] < -0.9999, "constexpr fit derivative");
+    auto cube_runtime = PolyApprox<double, 8>::create<double>([](double x) {return x*x*x - x;}, -1, 1);
+    for (unsigned i=0;i<8;i++)
+        if (cube.getCoefficients(i) != cube_runtime.getCoefficients(i))
+            return 6;
+    for (double x=-1;x<1;x+=1e-2)
+        if (cube(x) != cube_runtime(x))
+            return 7;
+#endif
+
+    return 0;
+}